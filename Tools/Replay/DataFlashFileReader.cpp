@@ -20,6 +20,11 @@ AP_LoggerFileReader::AP_LoggerFileReader()
 AP_LoggerFileReader::~AP_LoggerFileReader()
 {
     ::printf("Replay counts: %" PRIu64 " bytes  %u entries\n", bytes_read, message_count);
+    delete[] read_buf;
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    delete[] frame_in;
+    delete[] frame_out;
+#endif
 }
 
 bool AP_LoggerFileReader::open_log(const char *logfile)
@@ -33,16 +38,107 @@ bool AP_LoggerFileReader::open_log(const char *logfile)
     if (AP::FS().stat(logfile, &st) == 0) {
         file_size = st.st_size;
     }
+
+    read_buf = NEW_NOTHROW uint8_t[LOGREADER_READ_BUFFER_SIZE];
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    // compressed logs start with a frame header rather than a message
+    uint32_t magic;
+    if (AP::FS().read(fd, &magic, sizeof(magic)) == sizeof(magic) &&
+        magic == LOG_COMPRESS_FRAME_MAGIC) {
+        frame_in = NEW_NOTHROW uint8_t[UINT16_MAX];
+        frame_out = NEW_NOTHROW uint8_t[UINT16_MAX];
+        if (frame_in == nullptr || frame_out == nullptr) {
+            ::printf("Out of memory for compressed log\n");
+            return false;
+        }
+        compressed = true;
+        ::printf("Reading compressed log\n");
+    }
+    AP::FS().lseek(fd, 0, SEEK_SET);
+#endif
     return true;
 }
 
-ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
+ssize_t AP_LoggerFileReader::read_file(void *buffer, const size_t count)
 {
-    uint64_t ret = AP::FS().read(fd, buffer, count);
+    if (read_buf == nullptr) {
+        uint64_t ret = AP::FS().read(fd, buffer, count);
+        bytes_read += ret;
+        return ret;
+    }
+    uint8_t *dest = (uint8_t *)buffer;
+    size_t ret = 0;
+    while (ret < count) {
+        if (read_buf_ofs == read_buf_len) {
+            const ssize_t n = AP::FS().read(fd, read_buf, LOGREADER_READ_BUFFER_SIZE);
+            if (n <= 0) {
+                break;
+            }
+            read_buf_len = n;
+            read_buf_ofs = 0;
+        }
+        const size_t n = MIN(count - ret, size_t(read_buf_len - read_buf_ofs));
+        memcpy(&dest[ret], &read_buf[read_buf_ofs], n);
+        read_buf_ofs += n;
+        ret += n;
+    }
     bytes_read += ret;
     return ret;
 }
 
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+/*
+  read and decompress the next frame of a compressed log
+ */
+bool AP_LoggerFileReader::read_frame()
+{
+    log_compress_frame_header hdr;
+    if (read_file(&hdr, sizeof(hdr)) != sizeof(hdr)) {
+        return false;
+    }
+    if (hdr.magic != LOG_COMPRESS_FRAME_MAGIC || hdr.comp_len > hdr.raw_len) {
+        printf("bad compressed log frame\n");
+        return false;
+    }
+    if (read_file(frame_in, hdr.comp_len) != hdr.comp_len) {
+        return false;
+    }
+    if (hdr.comp_len == hdr.raw_len) {
+        // frame stored uncompressed
+        memcpy(frame_out, frame_in, hdr.raw_len);
+    } else if (log_decompress_block(frame_in, hdr.comp_len, frame_out, UINT16_MAX) != hdr.raw_len) {
+        printf("corrupt compressed log frame\n");
+        return false;
+    }
+    frame_out_len = hdr.raw_len;
+    frame_out_ofs = 0;
+    return true;
+}
+#endif
+
+ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
+{
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    if (compressed) {
+        // messages may span frames
+        uint8_t *dest = (uint8_t *)buffer;
+        size_t ret = 0;
+        while (ret < count) {
+            if (frame_out_ofs == frame_out_len && !read_frame()) {
+                break;
+            }
+            const size_t n = MIN(count - ret, size_t(frame_out_len - frame_out_ofs));
+            memcpy(&dest[ret], &frame_out[frame_out_ofs], n);
+            frame_out_ofs += n;
+            ret += n;
+        }
+        return ret;
+    }
+#endif
+    return read_file(buffer, count);
+}
+
 void AP_LoggerFileReader::format_type(uint16_t type, char dest[5])
 {
     const struct log_Format &f = formats[type];
@@ -1,9 +1,20 @@
 #pragma once
 
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Logger/AP_Logger_Compress.h>
 
 #define LOGREADER_MAX_FORMATS 255 // must be >= highest MESSAGE
 
+// size of the buffer file reads are made through, avoiding a read
+// call for every message
+#ifndef LOGREADER_READ_BUFFER_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+#define LOGREADER_READ_BUFFER_SIZE 4096
+#else
+#define LOGREADER_READ_BUFFER_SIZE 262144
+#endif
+#endif
+
 class AP_LoggerFileReader
 {
 public:
@@ -28,6 +39,21 @@ protected:
 
 private:
     ssize_t read_input(void *buf, size_t count);
+    ssize_t read_file(void *buf, size_t count);
+
+    uint8_t *read_buf;
+    uint32_t read_buf_len;
+    uint32_t read_buf_ofs;
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    // state for reading logs written with LOG_FILE_COMPRS
+    bool read_frame();
+    bool compressed;
+    uint8_t *frame_in;
+    uint8_t *frame_out;
+    uint16_t frame_out_len;
+    uint16_t frame_out_ofs;
+#endif
 
     uint64_t bytes_read = 0;
     uint64_t file_size = 0; // Total size of the log file
@@ -46,15 +46,99 @@ bool LogReader::in_list(const char *type, const char *list[])
     return false;
 }
 
-bool LogReader::handle_log_format_msg(const struct log_Format &f)
+/*
+  find the position of a message name in a comma separated list of
+  names, returns -1 if it is not in the list
+ */
+int8_t LogReader::output_type_index(const char *name, const char *types)
 {
-    // emit the output as we receive it:
-    AP::logger().WriteBlock((void*)&f, sizeof(f));
+    const size_t len = strnlen(name, 4);
+    int8_t index = 0;
+    for (const char *p = types; p != nullptr && *p; index++) {
+        const char *comma = strchr(p, ',');
+        const size_t tlen = comma ? size_t(comma - p) : strlen(p);
+        if (tlen == len && strncmp(p, name, len) == 0) {
+            return index < OUTPUT_TYPES_MAX ? index : -1;
+        }
+        p = comma ? comma+1 : nullptr;
+    }
+    return -1;
+}
+
+/*
+  mark a message type as written to the output log if its name is one
+  of the requested output types
+ */
+void LogReader::match_output_type(const char *name, uint8_t msg_type)
+{
+    const int8_t index = output_type_index(name, output_types);
+    if (index < 0) {
+        return;
+    }
+    output_filter.set(msg_type);
+    output_types_matched |= 1U << index;
+}
 
+// structures of the messages Replay writes itself, so the estimator
+// messages can be selected even when the input log has no FMT for them
+static const struct LogStructure replay_structures[] = {
+    LOG_COMMON_STRUCTURES
+};
+
+void LogReader::set_output_types(const char *types)
+{
+    output_types = types;
+    output_types_matched = 0;
+    output_filter.clearall();
+    // format messages are always needed to decode the output
+    output_filter.set(LOG_FORMAT_MSG);
+    output_filter.set(LOG_FORMAT_UNITS_MSG);
+    output_filter.set(LOG_UNIT_MSG);
+    output_filter.set(LOG_MULT_MSG);
+    for (const auto &s : replay_structures) {
+        match_output_type(s.name, s.msg_type);
+    }
+    AP::logger().set_replay_filter(&output_filter);
+}
+
+/*
+  warn about any requested output types which matched neither a
+  Replay message nor a message in the input log
+ */
+void LogReader::check_output_types() const
+{
+    if (output_types == nullptr) {
+        return;
+    }
+    int8_t index = 0;
+    for (const char *p = output_types; *p; index++) {
+        const char *comma = strchr(p, ',');
+        const int tlen = comma ? int(comma - p) : int(strlen(p));
+        if (index >= OUTPUT_TYPES_MAX) {
+            ::printf("Warning: --fast accepts at most %u types, ignored %.*s\n", unsigned(OUTPUT_TYPES_MAX), tlen, p);
+        } else if ((output_types_matched & (1U << index)) == 0) {
+            ::printf("Warning: --fast type %.*s matched no messages\n", tlen, p);
+        }
+        if (comma == nullptr) {
+            break;
+        }
+        p = comma+1;
+    }
+}
+
+bool LogReader::handle_log_format_msg(const struct log_Format &f)
+{
 	char name[5];
 	memset(name, '\0', 5);
 	memcpy(name, f.name, 4);
 
+    if (output_types != nullptr) {
+        match_output_type(name, f.type);
+    }
+
+    // emit the output as we receive it:
+    AP::logger().WriteBlock((void*)&f, sizeof(f));
+
     if (msgparser[f.type] != NULL) {
         return true;
     }
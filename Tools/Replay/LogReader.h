@@ -20,6 +20,13 @@ public:
 
     static bool in_list(const char *type, const char *list[]);
 
+    // analysis mode: only write message types named in the comma
+    // separated list to the output log
+    void set_output_types(const char *types);
+
+    // warn about requested output types which matched no messages
+    void check_output_types() const;
+
 protected:
 
 private:
@@ -31,6 +38,14 @@ private:
     uint8_t _log_structure_count;
 
     class LR_MsgHandler *msgparser[LOGREADER_MAX_FORMATS] {};
+
+    // message types written to the output log in analysis mode
+    static const uint8_t OUTPUT_TYPES_MAX = 32;
+    const char *output_types;
+    uint32_t output_types_matched;  // bitmask of output_types entries which matched a message
+    Bitmask<256> output_filter;
+    static int8_t output_type_index(const char *name, const char *types);
+    void match_output_type(const char *name, uint8_t msg_type);
 };
 
 // some vars are difficult to get through the layers
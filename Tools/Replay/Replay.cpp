@@ -39,6 +39,7 @@ static ReplayVehicle replayvehicle;
 user_parameter *user_parameters;
 bool replay_force_ekf2;
 bool replay_force_ekf3;
+const char *replay_output_types;
 bool show_progress;
 
 const AP_Param::Info ReplayVehicle::var_info[] = {
@@ -126,11 +127,13 @@ void Replay::usage(void)
     ::printf("\t--force-ekf2 force enable EKF2\n");
     ::printf("\t--force-ekf3 force enable EKF3\n");
     ::printf("\t--progress  show a progress bar during replay\n");
+    ::printf("\t--fast TYPES  analysis mode, only write the comma separated message TYPES (e.g. XKF1,XKF4) to the output log\n");
 }
 
 enum param_key : uint8_t {
     FORCE_EKF2 = 1,
     FORCE_EKF3,
+    FAST,
 };
 
 void Replay::_parse_command_line(uint8_t argc, char * const argv[])
@@ -143,6 +146,7 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"force-ekf2",      false,  0, param_key::FORCE_EKF2},
         {"force-ekf3",      false,  0, param_key::FORCE_EKF3},
         {"progress",        false,  0, 'P'},
+        {"fast",            true,   0, param_key::FAST},
         {"help",            false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -182,6 +186,10 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             show_progress = true;
             break;
 
+        case param_key::FAST:
+            replay_output_types = gopt.optarg;
+            break;
+
         case 'h':
         default:
             usage();
@@ -274,6 +282,10 @@ void Replay::setup()
         exit(1);
     }
 
+    if (replay_output_types != nullptr) {
+        reader.set_output_types(replay_output_types);
+    }
+
     if (filename == nullptr) {
 #if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
         // allow replay on stm32
@@ -297,6 +309,7 @@ void Replay::setup()
 void Replay::loop()
 {
     if (!reader.update()) {
+        reader.check_output_types();
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // If we don't tear down the threads then they continue to access
     // global state during object destruction.
@@ -31,6 +31,7 @@ struct user_parameter {
 extern user_parameter *user_parameters;
 extern bool replay_force_ekf2;
 extern bool replay_force_ekf3;
+extern const char *replay_output_types;
 
 class ReplayVehicle : public AP_Vehicle {
 public:
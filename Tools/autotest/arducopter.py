@@ -7269,6 +7269,25 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
                 "Notch-per-motor peak was higher than single-notch peak %fdB > %fdB" %
                 (esc_peakdb2, esc_peakdb1))
 
+    def SpeedupUnbounded(self):
+        '''check logging stays healthy with SIM_SPEEDUP=0'''
+        self.set_parameters({
+            "LOG_DISARMED": 1,
+            "SIM_SPEEDUP": 0,
+        })
+        self.reboot_sitl()
+
+        self.wait_sensor_state(mavutil.mavlink.MAV_SYS_STATUS_LOGGING, True, True, True)
+        # simulation time runs well ahead of the disk IO here
+        self.delay_sim_time(120)
+        self.assert_sensor_state(mavutil.mavlink.MAV_SYS_STATUS_LOGGING, True, True, True)
+
+        self.wait_ready_to_arm()
+        self.takeoff(10, mode="LOITER")
+        self.delay_sim_time(30)
+        self.assert_sensor_state(mavutil.mavlink.MAV_SYS_STATUS_LOGGING, True, True, True)
+        self.land_and_disarm()
+
     def DynamicRpmNotchesRateThread(self):
         """Use dynamic harmonic notch to control motor noise via ESC telemetry."""
         self.progress("Flying with ESC telemetry driven dynamic notches")
@@ -11205,6 +11224,30 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
 
         return current_log_filepath
 
+    def test_replay_threaded_lanes_bit(self):
+        self.set_parameters({
+            "LOG_REPLAY": 1,
+            "LOG_DISARMED": 1,
+            "EK3_ENABLE": 1,
+            "EK3_OPTIONS": 8,  # run lanes on worker threads
+        })
+        self.reboot_sitl()
+
+        self.wait_sensor_state(mavutil.mavlink.MAV_SYS_STATUS_LOGGING, True, True, True)
+
+        current_log_filepath = self.current_onboard_log_filepath()
+        self.progress("Current log path: %s" % str(current_log_filepath))
+
+        self.change_mode("LOITER")
+        self.wait_ready_to_arm(require_absolute=True)
+        self.arm_vehicle()
+        self.takeoffAndMoveAway()
+        self.do_RTL()
+
+        self.reboot_sitl()
+
+        return current_log_filepath
+
     def test_replay_beacon_bit(self):
         self.set_parameters({
             "LOG_REPLAY": 1,
@@ -11644,7 +11687,12 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
             self.start_subtest("%s" % name)
             self.test_replay_bit(func)
 
-    def test_replay_bit(self, bit):
+        # lanes run on worker threads in the vehicle and sequentially
+        # in Replay must give identical results
+        self.start_subtest("ThreadedLanes")
+        self.test_replay_bit(self.test_replay_threaded_lanes_bit, replay_args=["--parm", "EK3_OPTIONS=0"])
+
+    def test_replay_bit(self, bit, replay_args=None):
 
         self.context_push()
         current_log_filepath = bit()
@@ -11654,7 +11702,7 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         ))
 
         self.zero_throttle()
-        self.run_replay(current_log_filepath)
+        self.run_replay(current_log_filepath, args=replay_args)
 
         replay_log_filepath = self.current_onboard_log_filepath()
 
@@ -15775,6 +15823,7 @@ return update, 1000
             self.PositionWhenGPSIsZero,
             self.DynamicRpmNotches, # Do not add attempts to this - failure is sign of a bug
             self.DynamicRpmNotchesRateThread,
+            self.SpeedupUnbounded,
             self.PIDNotches,
             self.mission_NAV_LOITER_TURNS,
             self.mission_NAV_LOITER_TURNS_off_center,
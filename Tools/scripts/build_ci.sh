@@ -215,6 +215,8 @@ for t in $CI_BUILD_TARGET; do
 
     if [ "$t" == "unit-tests" ]; then
         run_autotest "Unit Tests" "build.unit_tests" "run.unit_tests"
+        echo "Testing log index script"
+        ./Tools/scripts/log_index_unittests.py
         continue
     fi
 
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+
+'''
+Convert a log written with LOG_FILE_COMPRS enabled into a normal
+DataFlash .bin log which can be loaded by pymavlink based tools.
+
+Logs which are not compressed are copied unchanged. Damaged frames are
+skipped by searching for the next frame header.
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import mmap
+import struct
+import sys
+
+FRAME_MAGIC = 0x5A4C5041
+FRAME_HEADER = struct.Struct('<IHH')
+MIN_MATCH = 4
+
+
+def read_length(data, pos, length):
+    '''read an LZ4 length extension'''
+    while True:
+        b = data[pos]
+        pos += 1
+        length += b
+        if b != 255:
+            return pos, length
+
+
+def lz4_decompress_block(data):
+    '''decompress one LZ4 block'''
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            pos, lit_len = read_length(data, pos, lit_len)
+        out += data[pos:pos+lit_len]
+        pos += lit_len
+        if pos >= len(data):
+            break
+        offset = data[pos] | (data[pos+1] << 8)
+        pos += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError("bad match offset %u" % offset)
+        match_len = token & 0x0F
+        if match_len == 15:
+            pos, match_len = read_length(data, pos, match_len)
+        match_len += MIN_MATCH
+        start = len(out) - offset
+        # matches may overlap the bytes they produce
+        for i in range(match_len):
+            out.append(out[start+i])
+    return bytes(out)
+
+
+def decode_frame(data, pos):
+    '''decode the frame at pos, returns (data, next_pos) or None if damaged'''
+    if pos + FRAME_HEADER.size > len(data):
+        return None
+    (magic, raw_len, comp_len) = FRAME_HEADER.unpack_from(data, pos)
+    if magic != FRAME_MAGIC or comp_len > raw_len:
+        return None
+    start = pos + FRAME_HEADER.size
+    end = start + comp_len
+    if end > len(data):
+        return None
+    payload = data[start:end]
+    if comp_len == raw_len:
+        return (payload, end)
+    try:
+        block = lz4_decompress_block(payload)
+    except (ValueError, IndexError):
+        return None
+    if len(block) != raw_len:
+        return None
+    return (block, end)
+
+
+def decompress_log(infile, outfile):
+    '''decompress infile into outfile, returns number of frames'''
+    try:
+        data = mmap.mmap(infile.fileno(), 0, access=mmap.ACCESS_READ)
+    except ValueError:
+        # empty file
+        return 0
+    if len(data) < FRAME_HEADER.size or FRAME_HEADER.unpack_from(data, 0)[0] != FRAME_MAGIC:
+        outfile.write(data)
+        return 0
+    magic_bytes = struct.pack('<I', FRAME_MAGIC)
+    pos = 0
+    frames = 0
+    while pos < len(data):
+        frame = decode_frame(data, pos)
+        if frame is None:
+            # skip to the next frame magic, the messages cut by the
+            # damaged frame are skipped by DataFlash log readers
+            next_pos = data.find(magic_bytes, pos+1)
+            if next_pos == -1:
+                print("Damaged frame at offset %u, no more frames" % pos, file=sys.stderr)
+                break
+            print("Damaged frame at offset %u, skipped %u bytes" % (pos, next_pos - pos), file=sys.stderr)
+            pos = next_pos
+            continue
+        (block, pos) = frame
+        outfile.write(block)
+        frames += 1
+    data.close()
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('infile', help='compressed log file')
+    parser.add_argument('outfile', help='output .bin file')
+    args = parser.parse_args()
+
+    with open(args.infile, 'rb') as infile, open(args.outfile, 'wb') as outfile:
+        frames = decompress_log(infile, outfile)
+    print("Decompressed %u frames" % frames)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+
+'''
+Time index for ArduPilot DataFlash .bin logs.
+
+The index records the file offset of the first message in every second
+of the log, the number of messages of each type, and the location of
+the messages needed to decode the log (FMT, FMTU, UNIT, MULT and PARM).
+It is stored next to the log as LOGNAME.idx and is rebuilt when the log
+changes.
+
+With the index a window of a long log can be pulled out without
+decoding everything before it:
+
+  log_index.py extract 00000042.BIN --start 3600 --end 3630 -o incident.bin
+
+The extracted log starts with all format, unit and parameter messages
+so it can be loaded by pymavlink based tools as usual.
+
+Compressed logs (LOG_FILE_COMPRS) must be converted with
+decompress_log.py first.
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import json
+import mmap
+import os
+import struct
+import sys
+
+INDEX_VERSION = 1
+
+HEAD1 = 0xA3
+HEAD2 = 0x95
+FMT_TYPE = 128
+FMT_STRUCT = struct.Struct('<3BBB4s16s64s')
+
+# messages copied into every extracted window so it can be decoded
+HEADER_MESSAGES = ('FMT', 'FMTU', 'UNIT', 'MULT', 'PARM')
+
+
+def index_filename(logfile):
+    '''return the name of the index file for a log'''
+    return logfile + '.idx'
+
+
+def build_index(logfile):
+    '''scan a log and return its index as a dictionary'''
+    with open(logfile, 'rb') as f:
+        st = os.fstat(f.fileno())
+        if st.st_size == 0:
+            # mmap can't map an empty file
+            return scan_log(b'', st)
+        # map rather than read so long logs are paged in as they are scanned
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as data:
+            return scan_log(data, st)
+
+
+def scan_log(data, st):
+    '''build the index for the log contents in data, st is the os.stat() of the log'''
+    lengths = {FMT_TYPE: FMT_STRUCT.size}
+    names = {FMT_TYPE: 'FMT'}
+    has_time = set()
+    counts = {}
+    seconds = []
+    headers = []
+    last_second = -1
+    ofs = 0
+    end = len(data)
+
+    while ofs + 3 <= end:
+        if data[ofs] != HEAD1 or data[ofs+1] != HEAD2:
+            # corrupt data, resync on the next header
+            ofs = data.find(bytes([HEAD1, HEAD2]), ofs+1)
+            if ofs == -1:
+                break
+            continue
+        msg_type = data[ofs+2]
+        length = lengths.get(msg_type)
+        if length is None or ofs + length > end:
+            ofs += 1
+            continue
+
+        if msg_type == FMT_TYPE:
+            (_, _, _, ftype, flen, fname, fformat, flabels) = FMT_STRUCT.unpack_from(data, ofs)
+            lengths[ftype] = flen
+            names[ftype] = fname.rstrip(b'\0').decode('ascii', 'replace')
+            if fformat.startswith(b'Q') and flabels.startswith(b'TimeUS'):
+                has_time.add(ftype)
+
+        name = names[msg_type]
+        counts[name] = counts.get(name, 0) + 1
+        if name in HEADER_MESSAGES:
+            headers.append((ofs, length))
+
+        if msg_type in has_time:
+            (time_us,) = struct.unpack_from('<Q', data, ofs+3)
+            second = time_us // 1000000
+            if second > last_second:
+                seconds.append((second, ofs))
+                last_second = second
+
+        ofs += length
+
+    return {
+        'version': INDEX_VERSION,
+        'size': st.st_size,
+        'mtime': int(st.st_mtime),
+        'seconds': seconds,
+        'counts': counts,
+        'headers': headers,
+    }
+
+
+def load_index(logfile, rebuild=False):
+    '''load the index for a log, building and saving it if needed'''
+    idxfile = index_filename(logfile)
+    st = os.stat(logfile)
+    if not rebuild and os.path.exists(idxfile):
+        try:
+            with open(idxfile, 'r') as f:
+                index = json.load(f)
+            if (index.get('version') == INDEX_VERSION and
+                    index.get('size') == st.st_size and
+                    index.get('mtime') == int(st.st_mtime)):
+                return index
+        except (OSError, ValueError):
+            pass
+    index = build_index(logfile)
+    try:
+        with open(idxfile, 'w') as f:
+            json.dump(index, f)
+    except OSError as e:
+        print("Unable to save index %s: %s" % (idxfile, e), file=sys.stderr)
+    return index
+
+
+def offset_for_time(index, t):
+    '''return the offset of the first message at or after t seconds since boot, None if past the end'''
+    for (second, ofs) in index['seconds']:
+        if second >= t:
+            return ofs
+    return None
+
+
+def extract_window(logfile, index, start, end, outfile):
+    '''write the messages between start and end seconds since boot to outfile, returns bytes of data copied'''
+    start_ofs = offset_for_time(index, int(start))
+    if start_ofs is None:
+        return 0
+    end_ofs = offset_for_time(index, int(end) + 1)
+    if end_ofs is None:
+        end_ofs = index['size']
+
+    with open(logfile, 'rb') as f:
+        # decoding information first. Formats may be written at any
+        # point in a log, so all of them are included. Parameters are
+        # included up to the end of the window
+        for (ofs, length) in index['headers']:
+            if ofs >= start_ofs and ofs < end_ofs:
+                # will be copied with the window
+                continue
+            f.seek(ofs)
+            msg = f.read(length)
+            if msg[2] != FMT_TYPE and ofs > end_ofs:
+                continue
+            outfile.write(msg)
+
+        f.seek(start_ofs)
+        outfile.write(f.read(end_ofs - start_ofs))
+    return end_ofs - start_ofs
+
+
+def show_info(logfile, index):
+    '''print a summary of an index'''
+    seconds = index['seconds']
+    if seconds:
+        print("%s: %u bytes, time %u to %u seconds since boot" % (logfile, index['size'], seconds[0][0], seconds[-1][0]))
+    else:
+        print("%s: %u bytes, no timestamped messages" % (logfile, index['size']))
+    for name in sorted(index['counts']):
+        print("  %-4s %u" % (name, index['counts'][name]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build and use time indexes for ArduPilot .bin logs')
+    parser.add_argument('--rebuild', action='store_true', help='rebuild the index even if it is up to date')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('build', help='build the index for a log')
+    p.add_argument('logfile')
+
+    p = sub.add_parser('info', help='show time range and message counts')
+    p.add_argument('logfile')
+
+    p = sub.add_parser('extract', help='extract a time window into a new log')
+    p.add_argument('logfile')
+    p.add_argument('--start', type=float, required=True, help='start of window, seconds since boot')
+    p.add_argument('--end', type=float, required=True, help='end of window, seconds since boot')
+    p.add_argument('-o', '--output', required=True, help='output .bin file')
+
+    args = parser.parse_args()
+
+    index = load_index(args.logfile, rebuild=args.rebuild)
+
+    if args.command == 'info':
+        show_info(args.logfile, index)
+    elif args.command == 'extract':
+        if args.end < args.start:
+            raise SystemExit("--end must not be before --start")
+        with open(args.output, 'wb') as outfile:
+            copied = extract_window(args.logfile, index, args.start, args.end, outfile)
+        if copied == 0:
+            raise SystemExit("No data in window")
+        print("Extracted %u bytes to %s" % (copied, args.output))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+
+"""
+Log Index Unit Tests
+
+AP_FLAKE8_CLEAN
+"""
+
+import io
+import os
+import struct
+import tempfile
+import unittest
+
+from log_index import (
+    FMT_STRUCT,
+    FMT_TYPE,
+    HEAD1,
+    HEAD2,
+    build_index,
+    extract_window,
+    load_index,
+    offset_for_time,
+)
+
+TST_TYPE = 200
+TST_STRUCT = struct.Struct('<3BQI')
+PARM_TYPE = 64
+PARM_STRUCT = struct.Struct('<3BQ16sf')
+
+
+def fmt_msg(msg_type, length, name, fmt, labels):
+    return FMT_STRUCT.pack(HEAD1, HEAD2, FMT_TYPE, msg_type, length,
+                           name.encode(), fmt.encode(), labels.encode())
+
+
+def tst_msg(time_us, value):
+    return TST_STRUCT.pack(HEAD1, HEAD2, TST_TYPE, time_us, value)
+
+
+def parm_msg(time_us, name, value):
+    return PARM_STRUCT.pack(HEAD1, HEAD2, PARM_TYPE, time_us, name.encode(), value)
+
+
+class TestLogIndex(unittest.TestCase):
+
+    def setUp(self):
+        '''write a small log, recording the offset of the first message in each second'''
+        self.tmpdir = tempfile.TemporaryDirectory()
+        self.logfile = os.path.join(self.tmpdir.name, 'test.bin')
+
+        log = io.BytesIO()
+        log.write(fmt_msg(FMT_TYPE, FMT_STRUCT.size, 'FMT', 'BBnNZ', 'Type,Length,Name,Format,Columns'))
+        log.write(fmt_msg(TST_TYPE, TST_STRUCT.size, 'TST', 'QI', 'TimeUS,Val'))
+        log.write(fmt_msg(PARM_TYPE, PARM_STRUCT.size, 'PARM', 'QNf', 'TimeUS,Name,Value'))
+        self.parm_ofs = log.tell()
+        log.write(parm_msg(0, 'LOG_BITMASK', 65535))
+
+        self.first_ofs = {0: self.parm_ofs}
+        for i in range(50):
+            time_us = 1000000 + i * 200000
+            if i == 20:
+                # garbage between messages must be skipped
+                log.write(b'\x00\xa3\x01\x02')
+            self.first_ofs.setdefault(time_us // 1000000, log.tell())
+            log.write(tst_msg(time_us, i))
+        self.log = log.getvalue()
+        with open(self.logfile, 'wb') as f:
+            f.write(self.log)
+
+    def tearDown(self):
+        self.tmpdir.cleanup()
+
+    def test_build_index(self):
+        index = build_index(self.logfile)
+        self.assertEqual(index['size'], len(self.log))
+        self.assertEqual(index['seconds'], sorted(self.first_ofs.items()))
+        self.assertEqual(index['counts'], {'FMT': 3, 'TST': 50, 'PARM': 1})
+        self.assertEqual(len(index['headers']), 4)
+        self.assertIn((self.parm_ofs, PARM_STRUCT.size), index['headers'])
+
+    def test_empty_log(self):
+        with open(self.logfile, 'wb'):
+            pass
+        index = build_index(self.logfile)
+        self.assertEqual(index['size'], 0)
+        self.assertEqual(index['seconds'], [])
+
+    def test_offset_for_time(self):
+        index = build_index(self.logfile)
+        self.assertEqual(offset_for_time(index, 0), self.parm_ofs)
+        self.assertEqual(offset_for_time(index, 1), self.first_ofs[1])
+        self.assertEqual(offset_for_time(index, 5), self.first_ofs[5])
+        self.assertIsNone(offset_for_time(index, 100))
+
+    def test_load_index_cached(self):
+        index = load_index(self.logfile)
+        self.assertTrue(os.path.exists(self.logfile + '.idx'))
+        # json turns the tuples into lists
+        self.assertEqual(load_index(self.logfile)['seconds'], [list(s) for s in index['seconds']])
+
+    def test_extract_window(self):
+        index = build_index(self.logfile)
+        out = io.BytesIO()
+        copied = extract_window(self.logfile, index, 3, 4, out)
+        self.assertEqual(copied, self.first_ofs[5] - self.first_ofs[3])
+
+        # the window is preceded by the formats and parameters
+        with open(self.logfile + '.out', 'wb') as f:
+            f.write(out.getvalue())
+        window = build_index(self.logfile + '.out')
+        self.assertEqual(window['counts'], {'FMT': 3, 'TST': 10, 'PARM': 1})
+        # the parameter message keeps its original timestamp
+        self.assertEqual([s[0] for s in window['seconds']], [0, 3, 4])
+
+
+if __name__ == '__main__':
+    unittest.main()
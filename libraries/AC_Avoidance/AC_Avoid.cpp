@@ -896,14 +896,20 @@ void AC_Avoid::adjust_velocity_inclusion_and_exclusion_polygons(float kP, float
     // for backing away
     Vector2f quad_1_back_vel_ne_cms, quad_2_back_vel_ne_cms, quad_3_back_vel_ne_cms, quad_4_back_vel_ne_cms;
 
+    // bounding boxes allow distant edges to be skipped
+    update_fence_edge_boxes(*fence);
+    uint16_t box_ofs = 0;
+
     // iterate through inclusion polygons
     const uint8_t num_inclusion_polygons = fence->polyfence().get_inclusion_polygon_count();
     for (uint8_t i = 0; i < num_inclusion_polygons; i++) {
         uint16_t num_points;
         const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+        const EdgeBox *edge_boxes = (_fence_edge_boxes != nullptr) ? &_fence_edge_boxes[box_ofs] : nullptr;
+        box_ofs += num_edge_boxes(num_points);
         Vector2f backup_vel_inc_ne_cms;
         // adjust velocity
-        adjust_velocity_polygon(kP, accel_cmss, desired_vel_ne_cms, backup_vel_inc_ne_cms, boundary, num_points, fence->get_margin_ne_m(), dt, true);
+        adjust_velocity_polygon(kP, accel_cmss, desired_vel_ne_cms, backup_vel_inc_ne_cms, boundary, num_points, fence->get_margin_ne_m(), dt, true, edge_boxes);
         find_max_quadrant_velocity(backup_vel_inc_ne_cms, quad_1_back_vel_ne_cms, quad_2_back_vel_ne_cms, quad_3_back_vel_ne_cms, quad_4_back_vel_ne_cms);
     }
 
@@ -912,15 +918,95 @@ void AC_Avoid::adjust_velocity_inclusion_and_exclusion_polygons(float kP, float
     for (uint8_t i = 0; i < num_exclusion_polygons; i++) {
         uint16_t num_points;
         const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+        const EdgeBox *edge_boxes = (_fence_edge_boxes != nullptr) ? &_fence_edge_boxes[box_ofs] : nullptr;
+        box_ofs += num_edge_boxes(num_points);
         Vector2f backup_vel_exc_ne_cms;
         // adjust velocity
-        adjust_velocity_polygon(kP, accel_cmss, desired_vel_ne_cms, backup_vel_exc_ne_cms, boundary, num_points, fence->get_margin_ne_m(), dt, false);
+        adjust_velocity_polygon(kP, accel_cmss, desired_vel_ne_cms, backup_vel_exc_ne_cms, boundary, num_points, fence->get_margin_ne_m(), dt, false, edge_boxes);
         find_max_quadrant_velocity(backup_vel_exc_ne_cms, quad_1_back_vel_ne_cms, quad_2_back_vel_ne_cms, quad_3_back_vel_ne_cms, quad_4_back_vel_ne_cms);
     }
     // desired backup velocity is sum of maximum velocity component in each quadrant 
     backup_vel_ne_cms = quad_1_back_vel_ne_cms + quad_2_back_vel_ne_cms + quad_3_back_vel_ne_cms + quad_4_back_vel_ne_cms;
 }
 
+/*
+ * Rebuilds the bounding boxes of groups of polygon fence edges when the fence is (re)loaded
+ * On allocation failure _fence_edge_boxes is nullptr and all edges are checked
+ */
+void AC_Avoid::update_fence_edge_boxes(const AC_Fence &fence)
+{
+    const AC_PolyFence_loader &polyfence = fence.polyfence();
+    const uint32_t update_ms = polyfence.get_inclusion_polygon_update_ms();
+    if (update_ms == _fence_edge_boxes_update_ms) {
+        return;
+    }
+    _fence_edge_boxes_update_ms = update_ms;
+
+    const uint8_t num_inclusion_polygons = polyfence.get_inclusion_polygon_count();
+    const uint8_t num_exclusion_polygons = polyfence.get_exclusion_polygon_count();
+    const uint8_t num_polygons = num_inclusion_polygons + num_exclusion_polygons;
+
+    // count the boxes required
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < num_polygons; i++) {
+        uint16_t num_points = 0;
+        if (i < num_inclusion_polygons) {
+            polyfence.get_inclusion_polygon(i, num_points);
+        } else {
+            polyfence.get_exclusion_polygon(i - num_inclusion_polygons, num_points);
+        }
+        count += num_edge_boxes(num_points);
+    }
+    if (count > UINT16_MAX) {
+        count = 0;
+    }
+
+    if (count > _fence_edge_boxes_max || count == 0) {
+        delete[] _fence_edge_boxes;
+        _fence_edge_boxes = nullptr;
+        _fence_edge_boxes_max = 0;
+        if (count == 0) {
+            return;
+        }
+        _fence_edge_boxes = NEW_NOTHROW EdgeBox[count];
+        if (_fence_edge_boxes == nullptr) {
+            return;
+        }
+        _fence_edge_boxes_max = count;
+    }
+
+    // fill in boxes, each covering edges from boundary[k] to boundary[k+1] (wrapping to boundary[0])
+    uint16_t box_ofs = 0;
+    for (uint8_t i = 0; i < num_polygons; i++) {
+        uint16_t num_points = 0;
+        const Vector2f *boundary;
+        if (i < num_inclusion_polygons) {
+            boundary = polyfence.get_inclusion_polygon(i, num_points);
+        } else {
+            boundary = polyfence.get_exclusion_polygon(i - num_inclusion_polygons, num_points);
+        }
+        if (boundary == nullptr) {
+            // keep offsets consistent with adjust_velocity_inclusion_and_exclusion_polygons
+            box_ofs += num_edge_boxes(num_points);
+            continue;
+        }
+        for (uint16_t k = 0; k < num_points; k++) {
+            EdgeBox &box = _fence_edge_boxes[box_ofs + k / AC_AVOID_FENCE_EDGES_PER_BOX];
+            const Vector2f &start = boundary[k];
+            const Vector2f &end = boundary[(k + 1 < num_points) ? k + 1 : 0];
+            if (k % AC_AVOID_FENCE_EDGES_PER_BOX == 0) {
+                box.min_ne_cm = start;
+                box.max_ne_cm = start;
+            }
+            box.min_ne_cm.x = MIN(box.min_ne_cm.x, MIN(start.x, end.x));
+            box.min_ne_cm.y = MIN(box.min_ne_cm.y, MIN(start.y, end.y));
+            box.max_ne_cm.x = MAX(box.max_ne_cm.x, MAX(start.x, end.x));
+            box.max_ne_cm.y = MAX(box.max_ne_cm.y, MAX(start.y, end.y));
+        }
+        box_ofs += num_edge_boxes(num_points);
+    }
+}
+
 /*
  * Adjusts the desired velocity for the inclusion circles
  */
@@ -1360,7 +1446,7 @@ void AC_Avoid::adjust_velocity_proximity(float kP, float accel_cmss, Vector3f &d
 /*
  * Adjusts the desired velocity for the polygon fence.
  */
-void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, Vector2f &backup_vel_ne_cms, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside)
+void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, Vector2f &backup_vel_ne_cms, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside, const EdgeBox *edge_boxes)
 {
     // exit if there are no points
     if (boundary == nullptr || num_points == 0) {
@@ -1396,15 +1482,31 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
 
     // for stopping
     const float speed = safe_vel_ne_cms.length();
+    const float stopping_distance_cm = get_stopping_distance(kP, accel_cmss, speed);
     Vector2f stopping_point_plus_margin_ne_cm; 
     if (!desired_vel_cms.is_zero()) {
-        stopping_point_plus_margin_ne_cm = position_ne_cm + safe_vel_ne_cms*((2.0f + margin_cm + get_stopping_distance(kP, accel_cmss, speed))/speed);
+        stopping_point_plus_margin_ne_cm = position_ne_cm + safe_vel_ne_cms*((2.0f + margin_cm + stopping_distance_cm)/speed);
     }
 
+    // edges further away than this can neither require backing away nor
+    // limit the velocity, as the vehicle can stop (or slide) before reaching them
+    const float query_radius_cm = margin_cm + stopping_distance_cm + speed * MAX(dt, 0.0f) + AC_AVOID_FENCE_EDGE_QUERY_PAD_CM;
+    const float query_radius_sq = sq(query_radius_cm);
+
     // for backing away
     Vector2f quad_1_back_vel_ne_cms, quad_2_back_vel_ne_cms, quad_3_back_vel_ne_cms, quad_4_back_vel_ne_cms;
    
     for (uint16_t i=0; i<num_points; i++) {
+        if ((edge_boxes != nullptr) && ((i % AC_AVOID_FENCE_EDGES_PER_BOX) == 0)) {
+            // skip the whole group of edges if its bounding box is out of reach
+            const EdgeBox &box = edge_boxes[i / AC_AVOID_FENCE_EDGES_PER_BOX];
+            const float dx = MAX(MAX(box.min_ne_cm.x - position_ne_cm.x, position_ne_cm.x - box.max_ne_cm.x), 0.0f);
+            const float dy = MAX(MAX(box.min_ne_cm.y - position_ne_cm.y, position_ne_cm.y - box.max_ne_cm.y), 0.0f);
+            if (sq(dx) + sq(dy) > query_radius_sq) {
+                i += AC_AVOID_FENCE_EDGES_PER_BOX - 1;
+                continue;
+            }
+        }
         uint16_t j = i+1;
         if (j >= num_points) {
             j = 0;
@@ -25,6 +25,10 @@
 #define AC_AVOID_ACTIVE_LIMIT_TIMEOUT_MS    500     // if limiting is active if last limit is happened in the last x ms
 #define AC_AVOID_ACCEL_TIMEOUT_MS           200     // stored velocity used to calculate acceleration will be reset if avoidance is active after this many ms
 
+// definitions for polygon fence edge culling
+#define AC_AVOID_FENCE_EDGES_PER_BOX        8       // number of consecutive polygon fence edges covered by each bounding box
+#define AC_AVOID_FENCE_EDGE_QUERY_PAD_CM    100.0f  // extra distance (in cm) added to the stopping distance when deciding which fence edges to check
+
 /*
  * This class prevents the vehicle from leaving a polygon fence or hitting proximity-based obstacles
  * Additionally the vehicle may back up if the margin to obstacle is breached
@@ -153,13 +157,31 @@ private:
      */
     void adjust_velocity_proximity(float kP, float accel_cmss, Vector3f &desired_vel_neu_cms, Vector3f &backup_vel, float kP_z, float accel_z_cmss, float dt);
 
+    // axis-aligned bounding box of AC_AVOID_FENCE_EDGES_PER_BOX consecutive polygon edges
+    struct EdgeBox {
+        Vector2f min_ne_cm;
+        Vector2f max_ne_cm;
+    };
+
     /*
      * Adjusts the desired velocity given an array of boundary points
      * The boundary must be in Earth Frame
      * margin is the distance (in meters) that the vehicle should stop short of the polygon
      * stay_inside should be true for fences, false for exclusion polygons
+     * edge_boxes, if not nullptr, holds one EdgeBox per AC_AVOID_FENCE_EDGES_PER_BOX edges of the boundary
+     * and allows edges too far away to affect the velocity to be skipped
      */
-    void adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_neu_cms, Vector2f &backup_vel, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside);
+    void adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_neu_cms, Vector2f &backup_vel, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside, const EdgeBox *edge_boxes = nullptr);
+
+#if AP_FENCE_ENABLED
+    // rebuild the polygon fence edge bounding boxes if the fence has been reloaded
+    void update_fence_edge_boxes(const class AC_Fence &fence);
+
+    // number of bounding boxes needed for a polygon with num_points edges
+    static uint16_t num_edge_boxes(uint16_t num_points) {
+        return (num_points + AC_AVOID_FENCE_EDGES_PER_BOX - 1) / AC_AVOID_FENCE_EDGES_PER_BOX;
+    }
+#endif
 
     /*
      * Computes distance required to stop, given current speed.
@@ -226,6 +248,13 @@ private:
     uint32_t _last_log_ms;              // the last time simple avoidance was logged
     Vector3f _prev_avoid_vel_neu_cms;   // copy of avoidance adjusted velocity
 
+#if AP_FENCE_ENABLED
+    // bounding boxes of groups of polygon fence edges, for all inclusion polygons followed by all exclusion polygons
+    EdgeBox *_fence_edge_boxes = nullptr;
+    uint16_t _fence_edge_boxes_max = 0;          // number of elements allocated in _fence_edge_boxes
+    uint32_t _fence_edge_boxes_update_ms = 0;    // polygon fence load time the boxes were built for
+#endif
+
     static AC_Avoid *_singleton;
 };
 
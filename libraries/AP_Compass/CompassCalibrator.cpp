@@ -200,9 +200,12 @@ void CompassCalibrator::update()
         return;
     }
 
+    const uint32_t fit_start_us = AP_HAL::micros();
+
     if (_status == Status::RUNNING_STEP_ONE) {
         if (_fit_step >= 10) {
             if (is_equal(_fitness, _initial_fitness) || isnan(_fitness)) {  // if true, means that fitness is diverging instead of converging
+                report_fit_stats();
                 set_status(Status::FAILED);
             } else {
                 set_status(Status::RUNNING_STEP_TWO);
@@ -216,6 +219,7 @@ void CompassCalibrator::update()
         }
     } else if (_status == Status::RUNNING_STEP_TWO) {
         if (_fit_step >= 35) {
+            report_fit_stats();
             if (fit_acceptable() && fix_radius() && calculate_orientation()) {
                 set_status(Status::SUCCESS);
             } else {
@@ -229,6 +233,21 @@ void CompassCalibrator::update()
             _fit_step++;
         }
     }
+
+    _fit_stats.fit_time_us += AP_HAL::micros() - fit_start_us;
+}
+
+// report how the fit converged: the number of LM iterations which
+// improved or failed to improve the fitness, and the total time spent
+// fitting since the samples were collected
+void CompassCalibrator::report_fit_stats() const
+{
+    GCS_SEND_TEXT(MAV_SEVERITY_INFO, "Mag(%u) fit: %u/%u steps improved, %.1fms, rms %.2f",
+                  _compass_idx,
+                  _fit_stats.accepted,
+                  unsigned(_fit_stats.accepted + _fit_stats.rejected),
+                  (double)(_fit_stats.fit_time_us * 1.0e-3f),
+                  (double)sqrtf(_fitness));
 }
 
 void CompassCalibrator::pull_sample()
@@ -418,6 +437,7 @@ bool CompassCalibrator::set_status(CompassCalibrator::Status status)
             }
             if (_sample_buffer != nullptr) {
                 initialize_fit();
+                memset(&_fit_stats, 0, sizeof(_fit_stats));
                 _status = Status::RUNNING_STEP_ONE;
                 return true;
             }
@@ -604,28 +624,59 @@ void CompassCalibrator::calc_initial_offset()
     _params.offset /= _samples_collected;
 }
 
-void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const
+// calculate the sphere fit jacobian for a sample, returning the residual of the sample
+float CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const
 {
-    const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
+    const Vector3f s = sample + params.offset;
 
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
+    // A, B, C are the components of softiron*(sample+offset)
+    const float A = (diag.x    * s.x) + (offdiag.x * s.y) + (offdiag.y * s.z);
+    const float B = (offdiag.x * s.x) + (diag.y    * s.y) + (offdiag.z * s.z);
+    const float C = (offdiag.y * s.x) + (offdiag.z * s.y) + (diag.z    * s.z);
+    const float length = norm(A, B, C);
+    const float inv_length = 1.0f / length;
 
     // 0: partial derivative (radius wrt fitness fn) fn operated on sample
     ret[0] = 1.0f;
     // 1-3: partial derivative (offsets wrt fitness fn) fn operated on sample
-    ret[1] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[2] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
+    ret[1] = -((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C)) * inv_length;
+    ret[2] = -((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C)) * inv_length;
+    ret[3] = -((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C)) * inv_length;
+
+    return params.radius - length;
+}
+
+// accumulate the upper triangle of JTJ and JTFI over all samples in a
+// single pass, then mirror JTJ into its lower triangle. The residual
+// comes from the jacobian calculation so each sample is only decoded
+// and transformed once per iteration
+void CompassCalibrator::calc_normal_equations(const param_t& params, bool ellipsoid, float* JTJ, float* JTFI) const
+{
+    const uint8_t n = ellipsoid ? COMPASS_CAL_NUM_ELLIPSOID_PARAMS : COMPASS_CAL_NUM_SPHERE_PARAMS;
+
+    for (uint16_t k = 0; k < _samples_collected; k++) {
+        const Vector3f sample = _sample_buffer[k].get();
+
+        float jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+        const float resid = ellipsoid ? calc_ellipsoid_jacob(sample, params, jacob) : calc_sphere_jacob(sample, params, jacob);
+
+        for (uint8_t i = 0; i < n; i++) {
+            float *row = &JTJ[i*n];
+            const float ji = jacob[i];
+            for (uint8_t j = i; j < n; j++) {
+                row[j] += ji * jacob[j];
+            }
+            JTFI[i] += ji * resid;
+        }
+    }
+
+    for (uint8_t i = 1; i < n; i++) {
+        for (uint8_t j = 0; j < i; j++) {
+            JTJ[i*n+j] = JTJ[j*n+i];
+        }
+    }
 }
 
 // run sphere fit to calculate diagonals and offdiagonals
@@ -644,27 +695,14 @@ void CompassCalibrator::run_sphere_fit()
     fit1_params = fit2_params = _params;
 
     float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
+    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
     float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
 
     // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
+    calc_normal_equations(fit1_params, false, JTJ, JTFI);
 
-        float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
-
-        calc_sphere_jacob(sample, fit1_params, sphere_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
-            }
-            // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
+    // a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
@@ -674,10 +712,12 @@ void CompassCalibrator::run_sphere_fit()
     }
 
     if (!mat_inverse(JTJ, JTJ, 4)) {
+        _fit_stats.rejected++;
         return;
     }
 
     if (!mat_inverse(JTJ2, JTJ2, 4)) {
+        _fit_stats.rejected++;
         return;
     }
 
@@ -712,37 +752,40 @@ void CompassCalibrator::run_sphere_fit()
         _fitness = fitness;
         _params = fit1_params;
         update_completion_mask();
+        _fit_stats.accepted++;
+    } else {
+        _fit_stats.rejected++;
     }
 }
 
-void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const
+// calculate the ellipsoid fit jacobian for a sample, returning the residual of the sample
+float CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const
 {
-    const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
+    const Vector3f s = sample + params.offset;
 
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
+    // A, B, C are the components of softiron*(sample+offset)
+    const float A = (diag.x    * s.x) + (offdiag.x * s.y) + (offdiag.y * s.z);
+    const float B = (offdiag.x * s.x) + (diag.y    * s.y) + (offdiag.z * s.z);
+    const float C = (offdiag.y * s.x) + (offdiag.z * s.y) + (diag.z    * s.z);
+    const float length = norm(A, B, C);
+    const float inv_length = 1.0f / length;
 
     // 0-2: partial derivative (offset wrt fitness fn) fn operated on sample
-    ret[0] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[1] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[2] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
+    ret[0] = -((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C)) * inv_length;
+    ret[1] = -((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C)) * inv_length;
+    ret[2] = -((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C)) * inv_length;
     // 3-5: partial derivative (diag offset wrt fitness fn) fn operated on sample
-    ret[3] = -1.0f * ((sample.x + offset.x) * A)/length;
-    ret[4] = -1.0f * ((sample.y + offset.y) * B)/length;
-    ret[5] = -1.0f * ((sample.z + offset.z) * C)/length;
+    ret[3] = -(s.x * A) * inv_length;
+    ret[4] = -(s.y * B) * inv_length;
+    ret[5] = -(s.z * C) * inv_length;
     // 6-8: partial derivative (off-diag offset wrt fitness fn) fn operated on sample
-    ret[6] = -1.0f * (((sample.y + offset.y) * A) + ((sample.x + offset.x) * B))/length;
-    ret[7] = -1.0f * (((sample.z + offset.z) * A) + ((sample.x + offset.x) * C))/length;
-    ret[8] = -1.0f * (((sample.z + offset.z) * B) + ((sample.y + offset.y) * C))/length;
+    ret[6] = -((s.y * A) + (s.x * B)) * inv_length;
+    ret[7] = -((s.z * A) + (s.x * C)) * inv_length;
+    ret[8] = -((s.z * B) + (s.y * C)) * inv_length;
+
+    return params.radius - length;
 }
 
 void CompassCalibrator::run_ellipsoid_fit()
@@ -760,27 +803,14 @@ void CompassCalibrator::run_ellipsoid_fit()
     fit1_params = fit2_params = _params;
 
     float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
+    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
     float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
 
     // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
+    calc_normal_equations(fit1_params, true, JTJ, JTFI);
 
-        float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
-
-        calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-            }
-            // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
+    // a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
@@ -789,11 +819,13 @@ void CompassCalibrator::run_ellipsoid_fit()
         JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda/lma_damping;
     }
 
-    if (!mat_inverse(JTJ, JTJ, 9)) {
+    if (!mat_inverse_sym(JTJ, COMPASS_CAL_NUM_ELLIPSOID_PARAMS)) {
+        _fit_stats.rejected++;
         return;
     }
 
-    if (!mat_inverse(JTJ2, JTJ2, 9)) {
+    if (!mat_inverse_sym(JTJ2, COMPASS_CAL_NUM_ELLIPSOID_PARAMS)) {
+        _fit_stats.rejected++;
         return;
     }
 
@@ -828,6 +860,9 @@ void CompassCalibrator::run_ellipsoid_fit()
         _fitness = fitness;
         _params = fit1_params;
         update_completion_mask();
+        _fit_stats.accepted++;
+    } else {
+        _fit_stats.rejected++;
     }
 }
 
@@ -182,13 +182,20 @@ private:
     void calc_initial_offset();
 
     // run sphere fit to calculate diagonals and offdiagonals
-    void calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
+    // the jacobian calculations return the residual of the sample
+    float calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_sphere_fit();
 
     // run ellipsoid fit to calculate diagonals and offdiagonals
-    void calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
+    float calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_ellipsoid_fit();
 
+    // accumulate JTJ and JTFI for a sphere or ellipsoid fit over all samples
+    void calc_normal_equations(const param_t& params, bool ellipsoid, float* JTJ, float* JTFI) const;
+
+    // send fit convergence statistics to the GCS
+    void report_fit_stats() const;
+
     // update the completion mask based on a single sample
     void update_completion_mask(const Vector3f& sample);
 
@@ -234,6 +241,11 @@ private:
     float _initial_fitness;                 // fitness before latest "fit" was attempted (used to determine if fit was an improvement)
     float _sphere_lambda;                   // sphere fit's lambda
     float _ellipsoid_lambda;                // ellipsoid fit's lambda
+    struct {
+        uint16_t accepted;                  // fit iterations which improved the fitness
+        uint16_t rejected;                  // fit iterations which did not improve the fitness
+        uint32_t fit_time_us;               // total time spent fitting
+    } _fit_stats;
 
     // variables for orientation checking
     enum Rotation _orientation;             // latest detected orientation
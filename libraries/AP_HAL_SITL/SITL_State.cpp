@@ -26,6 +26,7 @@
 #include <AP_HAL/utility/Socket_native.h>
 
 #include <AP_HAL/SIMState.h>
+#include <AP_Logger/AP_Logger.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -104,31 +105,100 @@ void SITL_State::_fdm_input_step(void)
         return;
     }
 
+    const uint64_t t0 = wall_time_us();
     if (_sitl != nullptr) {
         _update_airspeed(_sitl->state.airspeed);
         _update_rangefinder();
     }
+    const uint64_t t1 = wall_time_us();
 
     // trigger all APM timers.
     HALSITL::Scheduler::timer_event();
     _scheduler->sitl_end_atomic();
+
+    _profile.sensors_us += t1 - t0;
+    _profile.vehicle_us += wall_time_us() - t1;
+}
+
+/*
+  monotonic wall clock time, as opposed to AP_HAL::micros64() which is
+  simulation time
+ */
+uint64_t SITL_State::wall_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000ULL;
+}
+
+/*
+  log the average wall clock time per simulation frame spent in each
+  part of SITL, once per second of simulation time
+ */
+void SITL_State::profile_log(void)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _profile.last_log_ms < 1000 || _profile.frames == 0) {
+        return;
+    }
+    _profile.last_log_ms = now_ms;
+
+    const uint64_t sleep_total_us = sitl_model->get_sleep_time_us();
+    const uint64_t sleep_us = sleep_total_us - _profile.sleep_us;
+    _profile.sleep_us = sleep_total_us;
+    // sleeping to match the speedup happens inside the physics update
+    const uint64_t physics_us = _profile.physics_us > sleep_us ? _profile.physics_us - sleep_us : 0;
+    const float scale = 1.0f / _profile.frames;
+
+#if HAL_LOGGING_ENABLED
+// @LoggerMessage: SIMP
+// @Description: SITL frame profile, wall clock time per simulation frame
+// @Field: TimeUS: Time since system startup
+// @Field: N: number of frames in this period
+// @Field: Phys: physics model update
+// @Field: Sens: simulated sensor update
+// @Field: Veh: vehicle code, including the main loop and timer callbacks
+// @Field: IO: servo, multicast and external simulator input/output, and waiting for serial0 to drain
+// @Field: Slp: sleeping to match SIM_SPEEDUP
+    AP::logger().WriteStreaming("SIMP", "TimeUS,N,Phys,Sens,Veh,IO,Slp",
+                                "s-sssss", "F-FFFFF", "QIfffff",
+                                AP_HAL::micros64(),
+                                _profile.frames,
+                                physics_us * scale,
+                                _profile.sensors_us * scale,
+                                _profile.vehicle_us * scale,
+                                _profile.io_us * scale,
+                                sleep_us * scale);
+#endif
+
+    _profile.physics_us = 0;
+    _profile.sensors_us = 0;
+    _profile.vehicle_us = 0;
+    _profile.io_us = 0;
+    _profile.frames = 0;
 }
 
 
 void SITL_State::wait_clock(uint64_t wait_time_usec)
 {
     float speedup = sitl_model->get_speedup();
+    // a speedup of zero means run as fast as possible
+    const bool max_speed = is_zero(speedup);
     if (speedup < 1) {
         // for purposes of sleeps treat low speedups as 1
         speedup = 1.0;
     }
+    const bool main_thread = hal.scheduler->in_main_thread();
+    if (main_thread && _profile.last_wait_exit_us != 0) {
+        _profile.vehicle_us += wall_time_us() - _profile.last_wait_exit_us;
+    }
     while (AP_HAL::micros64() < wait_time_usec) {
         if (hal.scheduler->in_main_thread() ||
             Scheduler::from(hal.scheduler)->semaphore_wait_hack_required()) {
             _fdm_input_step();
         } else {
 #ifdef CYGWIN_BUILD
-            if (speedup > 2 && hal.util->get_soft_armed()) {
+            if ((speedup > 2 || max_speed) && hal.util->get_soft_armed()) {
                 const char *current_thread = Scheduler::from(hal.scheduler)->get_current_thread_name();
                 if (current_thread && strcmp(current_thread, "Scripting") == 0) {
                     // this effectively does a yield of the CPU. The
@@ -150,7 +220,8 @@ void SITL_State::wait_clock(uint64_t wait_time_usec)
     // MAVProxy/pymavlink take too long to process packets and it ends
     // up seeing traffic well into our past and hits time-out
     // conditions.
-    if (speedup > 1 && hal.scheduler->in_main_thread()) {
+    if ((speedup > 1 || max_speed) && main_thread) {
+        const uint64_t t0 = wall_time_us();
         while (true) {
             HALSITL::UARTDriver *uart = (HALSITL::UARTDriver*)hal.serial(0);
             const int queue_length = uart->get_system_outqueue_length();
@@ -162,6 +233,11 @@ void SITL_State::wait_clock(uint64_t wait_time_usec)
             uart->handle_reading_from_device_to_readbuffer();
             usleep(1000);
         }
+        _profile.io_us += wall_time_us() - t0;
+    }
+    if (main_thread) {
+        profile_log();
+        _profile.last_wait_exit_us = wall_time_us();
     }
 }
 
@@ -211,6 +287,8 @@ void SITL_State::_fdm_input_local(void)
     }
     struct sitl_input input;
 
+    const uint64_t t0 = wall_time_us();
+
     // construct servos structure for FDM
     _simulator_servos(input);
 
@@ -222,6 +300,8 @@ void SITL_State::_fdm_input_local(void)
     // replace outputs from multicast
     multicast_servo_update(input);
 
+    const uint64_t t1 = wall_time_us();
+
     // update the model
     sitl_model->update_home();
     sitl_model->update_model(input);
@@ -229,6 +309,8 @@ void SITL_State::_fdm_input_local(void)
     // get FDM output from the model
     sitl_model->fill_fdm(_sitl->state);
 
+    const uint64_t t2 = wall_time_us();
+
 #if HAL_NUM_CAN_IFACES
     if (CANIface::num_interfaces() > 0) {
         multicast_state_send();
@@ -240,12 +322,21 @@ void SITL_State::_fdm_input_local(void)
     ride_along.send(_sitl->state,sitl_model->get_position_relhome());
 #endif  // AP_SIM_JSON_MASTER_ENABLED
 
+    const uint64_t t3 = wall_time_us();
+
     sim_update();
 
+    const uint64_t t4 = wall_time_us();
+
     if (_use_fg_view) {
         _output_to_flightgear();
     }
 
+    _profile.physics_us += t2 - t1;
+    _profile.sensors_us += t4 - t3;
+    _profile.io_us += (t1 - t0) + (t3 - t2) + (wall_time_us() - t4);
+    _profile.frames++;
+
     // update simulation time
     hal.scheduler->stop_clock(_sitl->state.timestamp_us);
 
@@ -74,6 +74,22 @@ private:
 
     void wait_clock(uint64_t wait_time_usec);
 
+    // wall clock time in microseconds, for profiling
+    static uint64_t wall_time_us(void);
+    void profile_log(void);
+
+    // wall clock breakdown of simulation frames, logged as SIMP
+    struct {
+        uint64_t physics_us;
+        uint64_t sensors_us;
+        uint64_t vehicle_us;
+        uint64_t io_us;
+        uint64_t sleep_us;              // model sleep total at last log
+        uint32_t frames;
+        uint64_t last_wait_exit_us;     // when the main thread last left wait_clock()
+        uint32_t last_log_ms;
+    } _profile;
+
     // internal state
     uint8_t _instance;
     uint16_t _base_port;
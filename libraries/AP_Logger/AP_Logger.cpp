@@ -203,6 +203,26 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @RebootRequired: True
     AP_GROUPINFO("_MAX_FILES", 12, AP_Logger, _params.max_log_files, MAX_LOG_FILES),
 
+#if HAL_LOGGING_FILESYSTEM_ENABLED
+    // @Param: _FILE_SYNC_MS
+    // @DisplayName: Log file sync interval
+    // @Description: Maximum time that written log data may remain unsynced to the storage device. Data is synced at most once per interval, so a longer interval costs fewer syncs but risks losing more data on power loss. A value of zero leaves syncing to the filesystem.
+    // @Units: ms
+    // @Range: 0 10000
+    // @Increment: 100
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_SYNC_MS", 14, AP_Logger, _params.file_sync_ms, 0),
+#endif
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    // @Param: _FILE_COMPRS
+    // @DisplayName: Log file compression
+    // @Description: Compress log files written to the filesystem. Compressed logs are smaller and need less write bandwidth. MAVLink log download decompresses them as they are sent, but a log copied off the card or over MAVLink FTP must be decompressed with Tools/scripts/decompress_log.py before being loaded by tools that do not understand the compressed format. Takes effect when the next log is started.
+    // @Values: 0:Disabled,1:LZ4
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_COMPRS", 13, AP_Logger, _params.file_compress, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -1065,7 +1085,7 @@ void AP_Logger::WriteV(const char *name, const char *labels, const char *units,
     for (uint8_t i=0; i<_next_backend; i++) {
         va_list arg_copy;
         va_copy(arg_copy, arg_list);
-        backends[i]->Write(f->msg_type, arg_copy, is_critical, is_streaming);
+        backends[i]->Write(f->msg_type, f->msg_len, f->fmt, arg_copy, is_critical, is_streaming);
         va_end(arg_copy);
     }
 }
@@ -1143,6 +1163,22 @@ AP_Logger::log_write_fmt *AP_Logger::msg_fmt_for_name(const char *name, const ch
 {
     WITH_SEMAPHORE(log_write_fmts_sem);
     struct log_write_fmt *f;
+
+    // most callers pass string literals for the name, so the pointer
+    // identifies the message and we can usually skip walking the list
+    const uint8_t cache_idx = (uintptr_t(name) >> 2) % LOG_WRITE_FMT_CACHE_SIZE;
+    if (!direct_comp) {
+        f = log_write_fmt_cache[cache_idx];
+        if (f != nullptr && f->name == name) {
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+            if (!assert_same_fmt_for_name(f, name, labels, units, mults, fmt)) {
+                return nullptr;
+            }
+#endif
+            return f;
+        }
+    }
+
     for (f = log_write_fmts; f; f=f->next) {
         if (!direct_comp) {
             if (f->name == name) { // ptr comparison
@@ -1152,6 +1188,7 @@ AP_Logger::log_write_fmt *AP_Logger::msg_fmt_for_name(const char *name, const ch
                     return nullptr;
                 }
 #endif
+                log_write_fmt_cache[cache_idx] = f;
                 return f;
             }
         } else {
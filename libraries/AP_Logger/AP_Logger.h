@@ -13,6 +13,8 @@
 #include <AP_Mission/AP_Mission.h>
 #include <AP_Logger/LogStructure.h>
 #include <AP_Vehicle/ModeReason.h>
+#include <AP_Vehicle/AP_Vehicle_Type.h>
+#include <AP_Common/Bitmask.h>
 
 #include <stdint.h>
 
@@ -231,6 +233,14 @@ public:
     /* Write a block of replay data at current offset */
     bool WriteReplayBlock(uint8_t msg_id, const void *pBuffer, uint16_t size);
 
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+    // restrict the message types Replay writes, nullptr to write all
+    void set_replay_filter(const Bitmask<256> *filter) { _replay_filter = filter; }
+    bool replay_should_write(uint8_t msg_type) const {
+        return _replay_filter == nullptr || _replay_filter->get(msg_type);
+    }
+#endif
+
     // high level interface
     uint16_t find_last_log() const;
     void get_log_boundaries(uint16_t log_num, uint32_t & start_page, uint32_t & end_page);
@@ -364,6 +374,10 @@ public:
         AP_Float blk_ratemax;
         AP_Float disarm_ratemax;
         AP_Int16 max_log_files;
+        AP_Int16 file_sync_ms;
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+        AP_Int8 file_compress;
+#endif
     } _params;
 
     const struct LogStructure *structure(uint16_t num) const;
@@ -415,6 +429,12 @@ public:
         const char *mults;
     } *log_write_fmts;
 
+    // formats recently looked up by name pointer, indexed by a hash
+    // of the pointer. Entries in log_write_fmts are never freed so a
+    // cached pointer stays valid
+    static const uint8_t LOG_WRITE_FMT_CACHE_SIZE = 16;
+    struct log_write_fmt *log_write_fmt_cache[LOG_WRITE_FMT_CACHE_SIZE];
+
     // return (possibly allocating) a log_write_fmt for a name
     struct log_write_fmt *msg_fmt_for_name(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, const bool direct_comp = false, const bool copy_strings = false);
 
@@ -446,6 +466,10 @@ protected:
                                bool is_critical);
 
 private:
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+    const Bitmask<256> *_replay_filter = nullptr;
+#endif
+
     #define LOGGER_MAX_BACKENDS 2
     uint8_t _next_backend;
     AP_Logger_Backend *backends[LOGGER_MAX_BACKENDS];
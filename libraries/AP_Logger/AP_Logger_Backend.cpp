@@ -99,6 +99,9 @@ void AP_Logger_Backend::periodic_tasks()
 void AP_Logger_Backend::start_new_log_reset_variables()
 {
     _dropped = 0;
+#if AP_LOGGER_DROP_STATS_ENABLED
+    memset(dropped_by_type, 0, sizeof(dropped_by_type));
+#endif
     _startup_messagewriter->reset();
     _front.backend_starting_new_log(this);
     _formats_written.clearall();
@@ -194,25 +197,11 @@ bool AP_Logger_Backend::Write_Emit_FMT(uint8_t msg_type)
     return true;
 }
 
-bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_critical, bool is_streaming)
+bool AP_Logger_Backend::Write(const uint8_t msg_type, const uint8_t msg_len, const char *fmt, va_list arg_list, bool is_critical, bool is_streaming)
 {
     // stack-allocate a buffer so we can WriteBlock(); this could be
     // 255 bytes!  If we were willing to lose the WriteBlock
     // abstraction we could do WriteBytes() here instead?
-    const char *fmt  = nullptr;
-    uint8_t msg_len;
-    AP_Logger::log_write_fmt *f;
-    for (f = _front.log_write_fmts; f; f=f->next) {
-        if (f->msg_type == msg_type) {
-            fmt = f->fmt;
-            msg_len = f->msg_len;
-            break;
-        }
-    }
-    if (fmt == nullptr) {
-        INTERNAL_ERROR(AP_InternalError::error_t::logger_logwrite_missingfmt);
-        return false;
-    }
     if (bufferspace_available() < msg_len) {
         return false;
     }
@@ -222,9 +211,9 @@ bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_
     buffer[offset++] = HEAD_BYTE1;
     buffer[offset++] = HEAD_BYTE2;
     buffer[offset++] = msg_type;
-    for (uint8_t i=0; i<strlen(fmt); i++) {
+    for (const char *p = fmt; *p; p++) {
         uint8_t charlen = 0;
-        switch(fmt[i]) {
+        switch(*p) {
         case 'b': {
             int8_t tmp = va_arg(arg_list, int);
             memcpy(&buffer[offset], &tmp, sizeof(int8_t));
@@ -447,6 +436,12 @@ bool AP_Logger_Backend::WritePrioritisedBlock(const void *pBuffer, uint16_t size
     if (!ShouldLog(is_critical)) {
         return false;
     }
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+    if (!_front.replay_should_write(((const uint8_t *)pBuffer)[2])) {
+        // deliberately discarded, not a failure
+        return true;
+    }
+#endif
     if (StartNewLogOK()) {
         start_new_log();
     }
@@ -696,6 +691,9 @@ void AP_Logger_Backend::Write_AP_Logger_Stats_File(const struct df_stats &_stats
         buf_space_min   : _stats.buf_space_min,
         buf_space_max   : _stats.buf_space_max,
         buf_space_avg   : (_stats.blocks) ? (_stats.buf_space_sigma / _stats.blocks) : 0,
+        comp_in         : _stats.comp_in,
+        comp_out        : _stats.comp_out,
+        comp_us         : _stats.comp_us,
     };
     WriteBlock(&pkt, sizeof(pkt));
 }
@@ -713,6 +711,57 @@ void AP_Logger_Backend::df_stats_gather(const uint16_t bytes_written, uint32_t s
     stats.blocks++;
 }
 
+// record a block passed through log compression
+void AP_Logger_Backend::df_stats_compression(uint32_t bytes_in, uint32_t bytes_out, uint32_t time_us)
+{
+    stats.comp_in += bytes_in;
+    stats.comp_out += bytes_out;
+    stats.comp_us += time_us;
+}
+
+// record a message dropped for lack of buffer space
+void AP_Logger_Backend::df_stats_dropped(const void *pBuffer, uint16_t size)
+{
+    _dropped++;
+#if AP_LOGGER_DROP_STATS_ENABLED
+    if (size > 2) {
+        const uint8_t msg_type = ((const uint8_t *)pBuffer)[2];
+        if (dropped_by_type[msg_type] < UINT16_MAX) {
+            dropped_by_type[msg_type]++;
+        }
+    }
+#endif
+}
+
+#if AP_LOGGER_DROP_STATS_ENABLED
+/*
+  write a DSFD message for each message type dropped since the last
+  call. The number written per call is limited so a badly overloaded
+  buffer is not flooded; remaining types are written on later calls
+ */
+void AP_Logger_Backend::Write_AP_Logger_Drop_Stats()
+{
+    const uint8_t max_per_call = 8;
+    uint8_t written = 0;
+    for (uint16_t i=0; i<ARRAY_SIZE(dropped_by_type) && written < max_per_call; i++) {
+        const uint8_t msg_type = dropped_by_type_next++;
+        const uint16_t count = dropped_by_type[msg_type];
+        if (count == 0) {
+            continue;
+        }
+        dropped_by_type[msg_type] = 0;
+        const struct log_DSFD pkt {
+            LOG_PACKET_HEADER_INIT(LOG_DF_DROP_STATS),
+            time_us  : AP_HAL::micros64(),
+            msg_type : msg_type,
+            count    : count,
+        };
+        WriteBlock(&pkt, sizeof(pkt));
+        written++;
+    }
+}
+#endif
+
 void AP_Logger_Backend::df_stats_clear() {
     memset(&stats, '\0', sizeof(stats));
     stats.buf_space_min = -1;
@@ -721,6 +770,9 @@ void AP_Logger_Backend::df_stats_clear() {
 void AP_Logger_Backend::df_stats_log() {
     Write_AP_Logger_Stats_File(stats);
     df_stats_clear();
+#if AP_LOGGER_DROP_STATS_ENABLED
+    Write_AP_Logger_Drop_Stats();
+#endif
 }
 
 
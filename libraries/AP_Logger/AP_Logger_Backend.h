@@ -52,6 +52,7 @@ public:
 
     AP_Logger_Backend(AP_Logger &front,
                       class LoggerMessageWriter_DFLogStart *writer);
+    virtual ~AP_Logger_Backend() {}
 
     vehicle_startup_message_Writer vehicle_message_writer() const;
 
@@ -167,9 +168,9 @@ public:
     // output a FMT message if not already done so
     void Safe_Write_Emit_FMT(uint8_t msg_type);
 
-    // write a log message out to the log of msg_type type, with
-    // values contained in arg_list:
-    bool Write(uint8_t msg_type, va_list arg_list, bool is_critical=false, bool is_streaming=false);
+    // write a log message out to the log of msg_type type, with its
+    // already resolved length and format and values contained in arg_list
+    bool Write(uint8_t msg_type, uint8_t msg_len, const char *fmt, va_list arg_list, bool is_critical=false, bool is_streaming=false);
 
     // these methods are used for mavlink system status and arming checks
     virtual bool logging_enabled() const;
@@ -251,6 +252,8 @@ protected:
 
     void df_stats_gather(uint16_t bytes_written, uint32_t space_remaining);
     void df_stats_log();
+    void df_stats_compression(uint32_t bytes_in, uint32_t bytes_out, uint32_t time_us);
+    void df_stats_dropped(const void *pBuffer, uint16_t size);
     void df_stats_clear();
 
     AP_Logger_RateLimiter *rate_limiter;
@@ -263,9 +266,19 @@ private:
         uint32_t buf_space_min;
         uint32_t buf_space_max;
         uint32_t buf_space_sigma;
+        uint32_t comp_in;
+        uint32_t comp_out;
+        uint32_t comp_us;
     };
     struct df_stats stats;
 
+#if AP_LOGGER_DROP_STATS_ENABLED
+    // count of messages dropped for lack of buffer space, by message type
+    uint16_t dropped_by_type[256];
+    uint8_t dropped_by_type_next;
+    void Write_AP_Logger_Drop_Stats();
+#endif
+
     uint32_t _last_periodic_1Hz;
     uint32_t _last_periodic_10Hz;
     bool have_logged_armed;
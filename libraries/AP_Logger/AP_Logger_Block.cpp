@@ -153,14 +153,14 @@ bool AP_Logger_Block::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
     } else {
         // we reserve some amount of space for critical messages:
         if (!is_critical && space < critical_message_reserved_space(writebuf.get_size())) {
-            _dropped++;
+            df_stats_dropped(pBuffer, size);
             return false;
         }
     }
 
     // if no room for entire message - drop it:
     if (space < size) {
-        _dropped++;
+        df_stats_dropped(pBuffer, size);
         return false;
     }
 
@@ -897,11 +897,24 @@ void AP_Logger_Block::io_timer(void)
             stop_log_pending = false;
         }
 
-    // write at most one page
+    // write pages while there is a backlog. The chip programs each
+    // page in the background while the next one is filled from the
+    // ring buffer
     } else if (writebuf.available() >= df_PageSize - sizeof(struct PageHeader)) {
         WITH_SEMAPHORE(sem);
 
-        write_log_page();
+        const uint32_t start_us = AP_HAL::micros();
+        for (uint8_t i=0; i<HAL_LOGGER_BLOCK_MAX_PAGES_PER_IO; i++) {
+            write_log_page();
+            if (chip_full || (df_PageAdr-1) % df_PagePerBlock == 0) {
+                // a block erase has been started, don't wait for it here
+                break;
+            }
+            if (writebuf.available() < df_PageSize - sizeof(struct PageHeader) ||
+                AP_HAL::micros() - start_us > HAL_LOGGER_BLOCK_IO_BUDGET_US) {
+                break;
+            }
+        }
     }
 }
 
@@ -975,6 +988,13 @@ void AP_Logger_Block::flash_test()
         BufferToPage(i);
     }
     printf("Flash speed test: %ukB/s\n", unsigned((pages_to_check * df_PageSize * 1000) / (1024 * (AP_HAL::millis() - now_ms))));
+
+    // sequential read speed, as seen by log download
+    now_ms = AP_HAL::millis();
+    for (uint32_t i=1; i<=pages_to_check; i++) {
+        PageToBuffer(i);
+    }
+    printf("Flash read speed test: %ukB/s\n", unsigned((pages_to_check * df_PageSize * 1000) / (1024 * MAX(AP_HAL::millis() - now_ms, 1U))));
 }
 
 #endif // HAL_LOGGING_BLOCK_ENABLED
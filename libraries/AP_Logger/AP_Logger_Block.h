@@ -9,6 +9,15 @@
 
 #define BLOCK_LOG_VALIDATE 0
 
+// maximum number of pages written in one call of io_timer() when
+// there is a backlog, and the time allowed for them
+#ifndef HAL_LOGGER_BLOCK_MAX_PAGES_PER_IO
+#define HAL_LOGGER_BLOCK_MAX_PAGES_PER_IO 8
+#endif
+#ifndef HAL_LOGGER_BLOCK_IO_BUDGET_US
+#define HAL_LOGGER_BLOCK_IO_BUDGET_US 2000
+#endif
+
 class AP_Logger_Block : public AP_Logger_Backend {
 public:
     AP_Logger_Block(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer);
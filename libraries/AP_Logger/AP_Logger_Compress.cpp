@@ -0,0 +1,177 @@
+/*
+  LZ4 block format compression for log files, see AP_Logger_Compress.h
+
+  This is a simple greedy compressor which is fast enough to run on
+  the logging IO thread. Log data compresses well with it as message
+  headers, timestamps and slowly changing values repeat often within
+  a write chunk.
+ */
+
+#include "AP_Logger_Compress.h"
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+
+#include <string.h>
+
+#define LZ4_MIN_MATCH     4
+#define LZ4_MFLIMIT       12   // last match must start at least this far from the end
+#define LZ4_LAST_LITERALS 5    // last bytes are always literals
+#define LZ4_MAX_OFFSET    65535
+
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint16_t hash32(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - LOG_COMPRESS_HASH_BITS);
+}
+
+// write an LZ4 length extension
+static inline uint8_t *write_length(uint8_t *op, uint32_t len)
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = len;
+    return op;
+}
+
+// write a sequence of literals optionally followed by a match
+static uint8_t *write_sequence(uint8_t *op, const uint8_t *literals, uint32_t lit_len, uint16_t offset, uint32_t match_len)
+{
+    uint8_t *token = op++;
+    if (lit_len >= 15) {
+        *token = 15 << 4;
+        op = write_length(op, lit_len - 15);
+    } else {
+        *token = lit_len << 4;
+    }
+    memcpy(op, literals, lit_len);
+    op += lit_len;
+
+    if (match_len == 0) {
+        // final literal only sequence
+        return op;
+    }
+
+    *op++ = offset & 0xFF;
+    *op++ = offset >> 8;
+    match_len -= LZ4_MIN_MATCH;
+    if (match_len >= 15) {
+        *token |= 15;
+        op = write_length(op, match_len - 15);
+    } else {
+        *token |= match_len;
+    }
+    return op;
+}
+
+uint16_t log_compress_block(const uint8_t *in, uint16_t in_len, uint8_t *out, uint32_t out_max, uint16_t *hash_table)
+{
+    if (out_max < LOG_COMPRESS_BOUND(uint32_t(in_len)) ||
+        LOG_COMPRESS_BOUND(uint32_t(in_len)) > UINT16_MAX) {
+        return 0;
+    }
+
+    memset(hash_table, 0, LOG_COMPRESS_HASH_SIZE * sizeof(hash_table[0]));
+
+    uint8_t *op = out;
+    uint32_t anchor = 0;
+
+    if (in_len > LZ4_MFLIMIT) {
+        const uint32_t match_start_limit = in_len - LZ4_MFLIMIT;
+        const uint32_t match_end_limit = in_len - LZ4_LAST_LITERALS;
+        uint32_t ip = 0;
+        while (ip < match_start_limit) {
+            const uint32_t seq = read32(&in[ip]);
+            const uint16_t h = hash32(seq);
+            const uint32_t ref = hash_table[h];
+            hash_table[h] = ip;
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || read32(&in[ref]) != seq) {
+                ip++;
+                continue;
+            }
+            uint32_t match_len = LZ4_MIN_MATCH;
+            while (ip + match_len < match_end_limit && in[ref + match_len] == in[ip + match_len]) {
+                match_len++;
+            }
+            op = write_sequence(op, &in[anchor], ip - anchor, ip - ref, match_len);
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    op = write_sequence(op, &in[anchor], in_len - anchor, 0, 0);
+    return op - out;
+}
+
+// read an LZ4 length extension, returns false on truncated input
+static inline bool read_length(const uint8_t *in, uint32_t in_len, uint32_t &ip, uint32_t &len)
+{
+    uint8_t b;
+    do {
+        if (ip >= in_len) {
+            return false;
+        }
+        b = in[ip++];
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+int32_t log_decompress_block(const uint8_t *in, uint32_t in_len, uint8_t *out, uint32_t out_max)
+{
+    uint32_t ip = 0;
+    uint32_t op = 0;
+
+    while (ip < in_len) {
+        const uint8_t token = in[ip++];
+
+        uint32_t lit_len = token >> 4;
+        if (lit_len == 15 && !read_length(in, in_len, ip, lit_len)) {
+            return -1;
+        }
+        if (lit_len > in_len - ip || lit_len > out_max - op) {
+            return -1;
+        }
+        memcpy(&out[op], &in[ip], lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == in_len) {
+            // the last sequence has no match
+            break;
+        }
+
+        if (in_len - ip < 2) {
+            return -1;
+        }
+        const uint16_t offset = in[ip] | (in[ip+1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return -1;
+        }
+        uint32_t match_len = token & 0x0F;
+        if (match_len == 15 && !read_length(in, in_len, ip, match_len)) {
+            return -1;
+        }
+        match_len += LZ4_MIN_MATCH;
+        if (match_len > out_max - op) {
+            return -1;
+        }
+        // byte by byte copy as the match may overlap the output
+        for (uint32_t i = 0; i < match_len; i++) {
+            out[op] = out[op - offset];
+            op++;
+        }
+    }
+
+    return op;
+}
+
+#endif // AP_LOGGER_FILE_COMPRESSION_ENABLED
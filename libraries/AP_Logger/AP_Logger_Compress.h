@@ -0,0 +1,54 @@
+/*
+  block compression for log files
+
+  When LOG_FILE_COMPRS is enabled the file backend writes the log as a
+  sequence of frames, each holding one write chunk of the normal
+  DataFlash stream. Every frame starts with a header carrying a magic
+  number so readers can detect a compressed log from its first bytes.
+  The payload uses the LZ4 block format, or is stored as-is when it
+  does not compress.
+
+  Tools/scripts/decompress_log.py skips a damaged frame by searching
+  for the next magic. Replay and MAVLink log download stop at the
+  first damaged frame, as Replay does at a damaged plain log.
+ */
+#pragma once
+
+#include "AP_Logger_config.h"
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <stdint.h>
+
+#define LOG_COMPRESS_FRAME_MAGIC 0x5A4C5041 // "APLZ"
+
+// size of the match table used by log_compress_block
+#define LOG_COMPRESS_HASH_BITS 12
+#define LOG_COMPRESS_HASH_SIZE (1U<<LOG_COMPRESS_HASH_BITS)
+
+// worst case size of a compressed block of n bytes
+#define LOG_COMPRESS_BOUND(n) ((n) + (n)/255 + 16)
+
+struct PACKED log_compress_frame_header {
+    uint32_t magic;
+    uint16_t raw_len;   // length of the decompressed data
+    uint16_t comp_len;  // length of the payload, equal to raw_len if stored uncompressed
+};
+
+/*
+  compress in_len bytes into out using the LZ4 block format
+  out_max must be at least LOG_COMPRESS_BOUND(in_len)
+  hash_table must have LOG_COMPRESS_HASH_SIZE entries
+  returns the compressed length, or 0 on error
+ */
+uint16_t log_compress_block(const uint8_t *in, uint16_t in_len, uint8_t *out, uint32_t out_max, uint16_t *hash_table);
+
+/*
+  decompress an LZ4 block of in_len bytes into out
+  returns the decompressed length, or -1 if the block is corrupt or
+  does not fit in out_max bytes
+ */
+int32_t log_decompress_block(const uint8_t *in, uint32_t in_len, uint8_t *out, uint32_t out_max);
+
+#endif // AP_LOGGER_FILE_COMPRESSION_ENABLED
@@ -471,14 +471,14 @@ bool AP_Logger_File::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
     } else {
         // we reserve some amount of space for critical messages:
         if (!is_critical && space < critical_message_reserved_space(_writebuf.get_size())) {
-            _dropped++;
+            df_stats_dropped(pBuffer, size);
             return false;
         }
     }
 
     // if no room for entire message - drop it:
     if (space < size) {
-        _dropped++;
+        df_stats_dropped(pBuffer, size);
         return false;
     }
 
@@ -537,6 +537,44 @@ uint32_t AP_Logger_File::_get_log_size(const uint16_t log_num)
     return st.st_size;
 }
 
+/*
+  size of a log as served by get_log_data
+ */
+uint32_t AP_Logger_File::_get_log_download_size(const uint16_t log_num)
+{
+    const uint32_t size = _get_log_size(log_num);
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    if (size == 0) {
+        return 0;
+    }
+    char *fname = _log_file_name(log_num);
+    if (fname == nullptr) {
+        return 0;
+    }
+    if (_write_fd != -1 && write_fd_semaphore.take_nonblocking()) {
+        if (_write_filename != nullptr && strcmp(_write_filename, fname) == 0) {
+            // it is the file we are currently writing
+            const uint32_t ret = _compress.active ? _compress.raw_written : size;
+            free(fname);
+            write_fd_semaphore.give();
+            return ret;
+        }
+        write_fd_semaphore.give();
+    }
+    EXPECT_DELAY_MS(3000);
+    const int fd = AP::FS().open(fname, O_RDONLY);
+    free(fname);
+    if (fd == -1) {
+        return 0;
+    }
+    const uint32_t ret = log_is_compressed(fd) ? compressed_log_size(fd, size) : size;
+    AP::FS().close(fd);
+    return ret;
+#else
+    return size;
+#endif
+}
+
 uint32_t AP_Logger_File::_get_log_time(const uint16_t log_num)
 {
     char *fname = _log_file_name(log_num);
@@ -584,7 +622,7 @@ void AP_Logger_File::get_log_boundaries(const uint16_t list_entry, uint32_t & st
     }
 
     start_page = 0;
-    end_page = _get_log_size(log_num) / LOGGER_PAGE_SIZE;
+    end_page = _get_log_download_size(log_num) / LOGGER_PAGE_SIZE;
 }
 
 /*
@@ -627,9 +665,22 @@ int16_t AP_Logger_File::get_log_data(const uint16_t list_entry, const uint16_t p
         free(fname);
         _read_offset = 0;
         _read_fd_log_num = log_num;
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+        _read_compress.active = log_is_compressed(_read_fd);
+        _read_compress.next_frame = 0;
+        _read_compress.frame_start = 0;
+        _read_compress.frame_len = 0;
+        _read_compress.frame_loaded = false;
+#endif
     }
     uint32_t ofs = page * (uint32_t)LOGGER_PAGE_SIZE + offset;
 
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    if (_read_compress.active) {
+        return read_compressed(ofs, len, data);
+    }
+#endif
+
     if (ofs != _read_offset) {
         if (AP::FS().lseek(_read_fd, ofs, SEEK_SET) == (off_t)-1) {
             AP::FS().close(_read_fd);
@@ -651,6 +702,13 @@ void AP_Logger_File::end_log_transfer()
         AP::FS().close(_read_fd);
         _read_fd = -1;
     }
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    delete[] _read_compress.frame_in;
+    delete[] _read_compress.frame_out;
+    _read_compress.frame_in = nullptr;
+    _read_compress.frame_out = nullptr;
+    _read_compress.buf_size = 0;
+#endif
 }
 
 /*
@@ -666,7 +724,7 @@ void AP_Logger_File::get_log_info(const uint16_t list_entry, uint32_t &size, uin
         return;
     }
 
-    size = _get_log_size(log_num);
+    size = _get_log_download_size(log_num);
     time_utc = _get_log_time(log_num);
 }
 
@@ -846,6 +904,11 @@ void AP_Logger_File::start_new_log(void)
     _open_error_ms = 0;
     _write_offset = 0;
     _writebuf.clear();
+    _sync_pending = false;
+    _last_sync_ms = _last_write_ms;
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    compress_setup();
+#endif
     write_fd_semaphore.give();
 
     // now update lastlog.txt with the new log number
@@ -883,7 +946,11 @@ void AP_Logger_File::flush(void)
 #if APM_BUILD_TYPE(APM_BUILD_Replay) || APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
 {
     uint32_t tnow = AP_HAL::millis();
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    while (_write_fd != -1 && _initialised && !recent_open_error() && (_writebuf.available() || compress_frame_pending())) {
+#else
     while (_write_fd != -1 && _initialised && !recent_open_error() && _writebuf.available()) {
+#endif
         // convince the IO timer that it really is OK to write out
         // less than _writebuf_chunk bytes:
         if (tnow > 2001) { // avoid resetting _last_write_time to 0
@@ -935,13 +1002,23 @@ void AP_Logger_File::io_timer(void)
     }
 
     uint32_t nbytes = _writebuf.available();
-    if (nbytes == 0) {
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    // a partially written frame must be finished before anything else
+    const bool frame_pending = compress_frame_pending();
+#else
+    const bool frame_pending = false;
+#endif
+    if (nbytes == 0 && !frame_pending) {
+        sync_if_due(tnow);
         return;
     }
-    if (nbytes < _writebuf_chunk && 
+    if (!frame_pending && nbytes < _writebuf_chunk &&
+        nbytes < _writebuf.get_size() / 2 &&
         tnow - _last_write_time < 2000UL) {
         // write in _writebuf_chunk-sized chunks, but always write at
-        // least once per 2 seconds if data is available
+        // least once per 2 seconds if data is available, or if the
+        // buffer is small compared to the chunk size and is filling
+        sync_if_due(tnow);
         return;
     }
 
@@ -969,6 +1046,17 @@ void AP_Logger_File::io_timer(void)
     const uint8_t *head = _writebuf.readptr(size);
     nbytes = MIN(nbytes, size);
 
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    if (_compress.active) {
+        if (!frame_pending) {
+            last_io_operation = "compress";
+            compress_frame(head, nbytes);
+        }
+        head = &_compress.frame[_compress.frame_ofs];
+        nbytes = _compress.frame_len - _compress.frame_ofs;
+    }
+#endif
+
 #if !AP_FILESYSTEM_LITTLEFS_ENABLED
     // try to align writes on a 512 byte boundary to avoid filesystem reads
     if ((nbytes + _write_offset) % 512 != 0) {
@@ -1015,13 +1103,27 @@ void AP_Logger_File::io_timer(void)
         _last_write_failed = false;
         _last_write_ms = tnow;
         _write_offset += nwritten;
-        _writebuf.advance(nwritten);
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+        if (_compress.active) {
+            _compress.frame_ofs += nwritten;
+            if (!compress_frame_pending()) {
+                _compress.raw_written += ((const log_compress_frame_header *)_compress.frame)->raw_len;
+            }
+        } else
+#endif
+        {
+            _writebuf.advance(nwritten);
+        }
+
+        _sync_pending = true;
 
         // we know nwritten > 0 so we won't sync if bytes_until_fsync == 0
         if ((uint32_t)nwritten == bytes_until_fsync) {
             last_io_operation = "fsync";
             AP::FS().fsync(_write_fd);
             last_io_operation = "";
+            _sync_pending = false;
+            _last_sync_ms = tnow;
         }
 
 #if AP_RTC_ENABLED && CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
@@ -1038,8 +1140,224 @@ void AP_Logger_File::io_timer(void)
     }
 
     write_fd_semaphore.give();
+
+    sync_if_due(tnow);
+}
+
+/*
+  sync written data to the storage device if LOG_FILE_SYNC_MS has
+  passed since the last sync. Syncs are batched this way as each one
+  can stall the IO thread for a long time on SD cards
+ */
+void AP_Logger_File::sync_if_due(uint32_t tnow)
+{
+    const int16_t sync_ms = _front._params.file_sync_ms;
+    if (!_sync_pending || sync_ms <= 0 || tnow - _last_sync_ms < uint32_t(sync_ms)) {
+        return;
+    }
+    if (!write_fd_semaphore.take(1)) {
+        return;
+    }
+    if (_write_fd != -1) {
+        last_io_operation = "fsync";
+        AP::FS().fsync(_write_fd);
+        last_io_operation = "";
+    }
+    write_fd_semaphore.give();
+    _sync_pending = false;
+    _last_sync_ms = tnow;
+}
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+/*
+  enable or disable compression for a newly opened log according to
+  LOG_FILE_COMPRS. The buffers are allocated the first time they are
+  needed and kept for later logs
+ */
+void AP_Logger_File::compress_setup(void)
+{
+    _compress.active = false;
+    _compress.frame_len = 0;
+    _compress.frame_ofs = 0;
+    _compress.raw_written = 0;
+    if (_front._params.file_compress == 0) {
+        return;
+    }
+    if (_compress.frame == nullptr) {
+        _compress.frame = NEW_NOTHROW uint8_t[sizeof(log_compress_frame_header) + LOG_COMPRESS_BOUND(uint32_t(_writebuf_chunk))];
+    }
+    if (_compress.hash_table == nullptr) {
+        _compress.hash_table = NEW_NOTHROW uint16_t[LOG_COMPRESS_HASH_SIZE];
+    }
+    if (_compress.frame == nullptr || _compress.hash_table == nullptr) {
+        DEV_PRINTF("Out of memory for log compression\n");
+        return;
+    }
+    _compress.active = true;
+}
+
+/*
+  move len bytes from the head of _writebuf into a new frame. The data
+  is stored uncompressed if compression does not make it smaller
+ */
+void AP_Logger_File::compress_frame(const uint8_t *data, uint16_t len)
+{
+    const uint32_t start_us = AP_HAL::micros();
+
+    log_compress_frame_header hdr {};
+    hdr.magic = LOG_COMPRESS_FRAME_MAGIC;
+    hdr.raw_len = len;
+
+    uint8_t *payload = &_compress.frame[sizeof(hdr)];
+    hdr.comp_len = log_compress_block(data, len, payload, LOG_COMPRESS_BOUND(uint32_t(_writebuf_chunk)), _compress.hash_table);
+    if (hdr.comp_len == 0 || hdr.comp_len >= len) {
+        memcpy(payload, data, len);
+        hdr.comp_len = len;
+    }
+    memcpy(_compress.frame, &hdr, sizeof(hdr));
+
+    _compress.frame_len = sizeof(hdr) + hdr.comp_len;
+    _compress.frame_ofs = 0;
+    _writebuf.advance(len);
+
+    df_stats_compression(len, _compress.frame_len, AP_HAL::micros() - start_us);
+}
+
+/*
+  check for the frame magic at the start of a log, leaving the file
+  positioned at the start
+ */
+bool AP_Logger_File::log_is_compressed(int fd) const
+{
+    uint32_t magic;
+    const bool ret = AP::FS().lseek(fd, 0, SEEK_SET) == 0 &&
+                     AP::FS().read(fd, &magic, sizeof(magic)) == sizeof(magic) &&
+                     magic == LOG_COMPRESS_FRAME_MAGIC;
+    AP::FS().lseek(fd, 0, SEEK_SET);
+    return ret;
 }
 
+/*
+  find the decompressed size of a compressed log from its frame
+  headers. Like the download this stops at the first damaged or
+  truncated frame
+ */
+uint32_t AP_Logger_File::compressed_log_size(int fd, uint32_t file_size) const
+{
+    uint32_t ofs = 0;
+    uint32_t ret = 0;
+    log_compress_frame_header hdr;
+    while (ofs + sizeof(hdr) <= file_size) {
+        if (AP::FS().lseek(fd, ofs, SEEK_SET) != int32_t(ofs) ||
+            AP::FS().read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+            hdr.magic != LOG_COMPRESS_FRAME_MAGIC ||
+            hdr.comp_len > hdr.raw_len ||
+            ofs + sizeof(hdr) + hdr.comp_len > file_size) {
+            break;
+        }
+        ret += hdr.raw_len;
+        ofs += sizeof(hdr) + hdr.comp_len;
+    }
+    return ret;
+}
+
+/*
+  step to the next frame of the compressed log being read. Only the
+  header is read, so frames before the requested offset are skipped
+  cheaply
+ */
+bool AP_Logger_File::next_compressed_frame(void)
+{
+    log_compress_frame_header hdr;
+    if (AP::FS().lseek(_read_fd, _read_compress.next_frame, SEEK_SET) != int32_t(_read_compress.next_frame) ||
+        AP::FS().read(_read_fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+        hdr.magic != LOG_COMPRESS_FRAME_MAGIC ||
+        hdr.comp_len > hdr.raw_len) {
+        return false;
+    }
+    _read_compress.frame_start += _read_compress.frame_len;
+    _read_compress.frame_len = hdr.raw_len;
+    _read_compress.comp_len = hdr.comp_len;
+    _read_compress.next_frame += sizeof(hdr) + hdr.comp_len;
+    _read_compress.frame_loaded = false;
+    return true;
+}
+
+/*
+  read and decompress the payload of the current frame
+ */
+bool AP_Logger_File::load_compressed_frame(void)
+{
+    const uint16_t raw_len = _read_compress.frame_len;
+    const uint16_t comp_len = _read_compress.comp_len;
+    if (_read_compress.buf_size < raw_len) {
+        // frames are at most one write chunk, which may be larger
+        // than ours if the log came from another board
+        delete[] _read_compress.frame_in;
+        delete[] _read_compress.frame_out;
+        _read_compress.frame_in = NEW_NOTHROW uint8_t[raw_len];
+        _read_compress.frame_out = NEW_NOTHROW uint8_t[raw_len];
+        _read_compress.buf_size = raw_len;
+        if (_read_compress.frame_in == nullptr || _read_compress.frame_out == nullptr) {
+            delete[] _read_compress.frame_in;
+            delete[] _read_compress.frame_out;
+            _read_compress.frame_in = nullptr;
+            _read_compress.frame_out = nullptr;
+            _read_compress.buf_size = 0;
+            return false;
+        }
+    }
+    const uint32_t payload_ofs = _read_compress.next_frame - comp_len;
+    if (AP::FS().lseek(_read_fd, payload_ofs, SEEK_SET) != int32_t(payload_ofs)) {
+        return false;
+    }
+    if (comp_len == raw_len) {
+        // stored uncompressed
+        if (AP::FS().read(_read_fd, _read_compress.frame_out, raw_len) != raw_len) {
+            return false;
+        }
+    } else if (AP::FS().read(_read_fd, _read_compress.frame_in, comp_len) != comp_len ||
+               log_decompress_block(_read_compress.frame_in, comp_len, _read_compress.frame_out, raw_len) != raw_len) {
+        return false;
+    }
+    _read_compress.frame_loaded = true;
+    return true;
+}
+
+/*
+  fill data with len bytes from offset ofs of the decompressed log.
+  Returns fewer bytes at the end of the log or at a damaged frame
+ */
+int16_t AP_Logger_File::read_compressed(uint32_t ofs, uint16_t len, uint8_t *data)
+{
+    if (ofs < _read_compress.frame_start) {
+        // a resend of earlier data, start again from the first frame
+        _read_compress.next_frame = 0;
+        _read_compress.frame_start = 0;
+        _read_compress.frame_len = 0;
+        _read_compress.frame_loaded = false;
+    }
+    uint16_t ret = 0;
+    while (ret < len) {
+        const uint32_t pos = ofs + ret;
+        const uint32_t frame_end = _read_compress.frame_start + _read_compress.frame_len;
+        if (pos >= frame_end) {
+            if (!next_compressed_frame()) {
+                break;
+            }
+            continue;
+        }
+        if (!_read_compress.frame_loaded && !load_compressed_frame()) {
+            break;
+        }
+        const uint16_t n = MIN(uint32_t(len - ret), frame_end - pos);
+        memcpy(&data[ret], &_read_compress.frame_out[pos - _read_compress.frame_start], n);
+        ret += n;
+    }
+    return ret;
+}
+#endif // AP_LOGGER_FILE_COMPRESSION_ENABLED
+
 bool AP_Logger_File::io_thread_alive() const
 {
     if (!hal.scheduler->is_system_initialized()) {
@@ -1057,6 +1375,11 @@ bool AP_Logger_File::io_thread_alive() const
     // disk.  Unfortunately these hardware devices do not obey our
     // SITL speedup options, so we allow for it here.
     SITL::SIM *sitl = AP::sitl();
+    if (sitl != nullptr && is_zero(sitl->speedup)) {
+        // with an unbounded speedup there is no telling how much
+        // simulation time passes during a slow disk write
+        return true;
+    }
     if (sitl != nullptr && sitl->speedup > 0) {
         timeout_ms *= sitl->speedup;
     }
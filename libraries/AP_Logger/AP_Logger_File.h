@@ -10,11 +10,16 @@
 
 #include <AP_HAL/utility/RingBuffer.h>
 #include "AP_Logger_Backend.h"
+#include "AP_Logger_Compress.h"
 
 #if HAL_LOGGING_FILESYSTEM_ENABLED
 
 #ifndef HAL_LOGGER_WRITE_CHUNK_SIZE
-#if AP_FILESYSTEM_LITTLEFS_ENABLED
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+// SD cards and eMMC on companion boards sustain much higher rates
+// with large writes
+#define HAL_LOGGER_WRITE_CHUNK_SIZE 32768
+#elif AP_FILESYSTEM_LITTLEFS_ENABLED
 #define HAL_LOGGER_WRITE_CHUNK_SIZE 2048
 #elif AP_FILESYSTEM_FATFS_ENABLED
 #define HAL_LOGGER_WRITE_CHUNK_SIZE (AP_Filesystem_FATFS::get_io_size())
@@ -115,11 +120,52 @@ private:
     ByteBuffer _writebuf{0};
     const uint16_t _writebuf_chunk = HAL_LOGGER_WRITE_CHUNK_SIZE;
     uint32_t _last_write_time;
+    uint32_t _last_sync_ms;
+    bool _sync_pending;
+    void sync_if_due(uint32_t tnow);
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+    // compression state, a chunk taken from _writebuf is compressed
+    // into frame and written out before the next chunk is taken
+    struct {
+        bool active;
+        uint8_t *frame;
+        uint16_t *hash_table;
+        uint16_t frame_len;
+        uint16_t frame_ofs;
+        uint32_t raw_written;   // decompressed size of the frames written so far
+    } _compress;
+    void compress_setup(void);
+    void compress_frame(const uint8_t *data, uint16_t len);
+    bool compress_frame_pending(void) const {
+        return _compress.active && _compress.frame_ofs < _compress.frame_len;
+    }
+
+    // a compressed log is served decompressed by get_log_data, so the
+    // offsets and sizes seen over MAVLink are those of a plain log
+    struct {
+        bool active;
+        uint8_t *frame_in;
+        uint8_t *frame_out;
+        uint16_t buf_size;      // size of frame_in and frame_out
+        uint32_t next_frame;    // file offset of the header after the current frame
+        uint32_t frame_start;   // decompressed offset of the current frame
+        uint16_t frame_len;     // decompressed length of the current frame
+        uint16_t comp_len;      // payload length of the current frame
+        bool frame_loaded;      // frame_out holds the current frame
+    } _read_compress;
+    bool log_is_compressed(int fd) const;
+    uint32_t compressed_log_size(int fd, uint32_t file_size) const;
+    bool next_compressed_frame(void);
+    bool load_compressed_frame(void);
+    int16_t read_compressed(uint32_t ofs, uint16_t len, uint8_t *data);
+#endif
 
     /* construct a file name given a log number. Caller must free. */
     char *_log_file_name(const uint16_t log_num) const;
     char *_lastlog_file_name() const;
     uint32_t _get_log_size(const uint16_t log_num);
+    uint32_t _get_log_download_size(const uint16_t log_num);
     uint32_t _get_log_time(const uint16_t log_num);
 
     void stop_logging(void) override;
@@ -59,6 +59,13 @@ extern const AP_HAL::HAL& hal;
 #define JEDEC_ID_CYPRESS_S25FL128L     0x016018
 #define JEDEC_ID_GIGA_GD25Q16E         0xC84015
 
+AP_Logger_Flash_JEDEC::~AP_Logger_Flash_JEDEC()
+{
+    if (read_ahead != nullptr) {
+        hal.util->free_type(read_ahead, HAL_LOGGER_JEDEC_READ_AHEAD_PAGES * df_PageSize, AP_HAL::Util::MEM_DMA_SAFE);
+    }
+}
+
 void AP_Logger_Flash_JEDEC::Init()
 {
     dev = hal.spi->get_device("dataflash");
@@ -80,6 +87,10 @@ void AP_Logger_Flash_JEDEC::Init()
 
     flash_died = false;
 
+    // buffer for sequential reads, if this fails pages are read one
+    // at a time
+    read_ahead = (uint8_t *)hal.util->malloc_type(HAL_LOGGER_JEDEC_READ_AHEAD_PAGES * df_PageSize, AP_HAL::Util::MEM_DMA_SAFE);
+
     AP_Logger_Block::Init();
 
     //flash_test();
@@ -233,8 +244,17 @@ void AP_Logger_Flash_JEDEC::PageToBuffer(uint32_t pageNum)
         return;
     }
 
+    const bool sequential = read_cache_valid && pageNum == df_Read_PageAdr + 1;
     df_Read_PageAdr = pageNum;
 
+    // page already fetched by an earlier sequential read
+    if (read_ahead_count > 0 &&
+        pageNum >= read_ahead_page && pageNum < read_ahead_page + read_ahead_count) {
+        memcpy(buffer, &read_ahead[(pageNum - read_ahead_page) * df_PageSize], df_PageSize);
+        read_cache_valid = true;
+        return;
+    }
+
     WaitReady();
 
     uint32_t PageAdr = (pageNum-1) * df_PageSize;
@@ -242,7 +262,16 @@ void AP_Logger_Flash_JEDEC::PageToBuffer(uint32_t pageNum)
     WITH_SEMAPHORE(dev_sem);
     dev->set_chip_select(true);
     send_command_addr(JEDEC_READ_DATA, PageAdr);
-    dev->transfer(nullptr, 0, buffer, df_PageSize);
+    if (sequential && read_ahead != nullptr && pageNum < df_NumPages) {
+        // the read command continues across page boundaries, so fetch
+        // the following pages in the same transfer
+        read_ahead_page = pageNum;
+        read_ahead_count = MIN(uint32_t(HAL_LOGGER_JEDEC_READ_AHEAD_PAGES), df_NumPages + 1 - pageNum);
+        dev->transfer(nullptr, 0, read_ahead, read_ahead_count * df_PageSize);
+        memcpy(buffer, read_ahead, df_PageSize);
+    } else {
+        dev->transfer(nullptr, 0, buffer, df_PageSize);
+    }
     dev->set_chip_select(false);
 
     read_cache_valid = true;
@@ -259,6 +288,7 @@ void AP_Logger_Flash_JEDEC::BufferToPage(uint32_t pageNum)
     if (pageNum != df_Read_PageAdr) {
         read_cache_valid = false;
     }
+    read_ahead_count = 0;
 
     WriteEnable();
 
@@ -277,6 +307,7 @@ void AP_Logger_Flash_JEDEC::BufferToPage(uint32_t pageNum)
 */
 void AP_Logger_Flash_JEDEC::SectorErase(uint32_t blockNum)
 {
+    read_ahead_count = 0;
     WriteEnable();
 
     WITH_SEMAPHORE(dev_sem);
@@ -290,6 +321,7 @@ void AP_Logger_Flash_JEDEC::SectorErase(uint32_t blockNum)
 */
 void AP_Logger_Flash_JEDEC::Sector4kErase(uint32_t sectorNum)
 {
+    read_ahead_count = 0;
     WriteEnable();
 
     WITH_SEMAPHORE(dev_sem);
@@ -299,6 +331,7 @@ void AP_Logger_Flash_JEDEC::Sector4kErase(uint32_t sectorNum)
 
 void AP_Logger_Flash_JEDEC::StartErase()
 {
+    read_ahead_count = 0;
     WriteEnable();
 
     WITH_SEMAPHORE(dev_sem);
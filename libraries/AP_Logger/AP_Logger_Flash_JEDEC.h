@@ -9,10 +9,16 @@
 
 #if HAL_LOGGING_FLASH_JEDEC_ENABLED
 
+// number of pages read in one transfer when reading sequentially
+#ifndef HAL_LOGGER_JEDEC_READ_AHEAD_PAGES
+#define HAL_LOGGER_JEDEC_READ_AHEAD_PAGES 8
+#endif
+
 class AP_Logger_Flash_JEDEC : public AP_Logger_Block {
 public:
     AP_Logger_Flash_JEDEC(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer) :
         AP_Logger_Block(front, writer) {}
+    ~AP_Logger_Flash_JEDEC();
     static AP_Logger_Backend  *probe(AP_Logger &front,
                                      LoggerMessageWriter_DFLogStart *ls) {
         return NEW_NOTHROW AP_Logger_Flash_JEDEC(front, ls);
@@ -44,6 +50,11 @@ private:
     uint8_t erase_cmd;
     bool use_32bit_address;
     bool read_cache_valid;
+
+    // pages fetched ahead of a sequential read, allocated in Init()
+    uint8_t *read_ahead;
+    uint32_t read_ahead_page;
+    uint8_t read_ahead_count;
 };
 
 #endif // HAL_LOGGING_FLASH_JEDEC_ENABLED
@@ -217,17 +217,19 @@ void AP_Logger_W25NXX::PageToBuffer(uint32_t pageNum)
         return;
     }
 
+    const bool sequential = read_cache_valid && pageNum == df_Read_PageAdr + 1;
     df_Read_PageAdr = pageNum;
 
     WaitReady();
 
     uint32_t PageAdr = (pageNum-1);
 
-    {
+    if (pageNum != prefetch_page) {
         WITH_SEMAPHORE(dev_sem);
         // read page into internal buffer
         send_command_addr(JEDEC_PAGE_DATA_READ, PageAdr);
     }
+    prefetch_page = 0;
 
     // read from internal buffer into our buffer
     WaitReady();
@@ -245,6 +247,14 @@ void AP_Logger_W25NXX::PageToBuffer(uint32_t pageNum)
 
         read_cache_valid = true;
     }
+
+    // when reading sequentially, as for log download, load the next
+    // page into the internal buffer while the caller uses this one
+    if (sequential && pageNum < df_NumPages) {
+        WITH_SEMAPHORE(dev_sem);
+        send_command_addr(JEDEC_PAGE_DATA_READ, PageAdr + 1);
+        prefetch_page = pageNum + 1;
+    }
 }
 
 //#define AP_W25NXX_DEBUG
@@ -263,6 +273,8 @@ void AP_Logger_W25NXX::BufferToPage(uint32_t pageNum)
     if (pageNum != df_Read_PageAdr) {
         read_cache_valid = false;
     }
+    // writing replaces the contents of the internal buffer
+    prefetch_page = 0;
 
     WriteEnable();
 
@@ -304,6 +316,7 @@ void AP_Logger_W25NXX::BufferToPage(uint32_t pageNum)
 */
 void AP_Logger_W25NXX::SectorErase(uint32_t blockNum)
 {
+    prefetch_page = 0;
     WriteEnable();
     WITH_SEMAPHORE(dev_sem);
 
@@ -321,6 +334,7 @@ void AP_Logger_W25NXX::Sector4kErase(uint32_t sectorNum)
 
 void AP_Logger_W25NXX::StartErase()
 {
+    prefetch_page = 0;
     WriteEnable();
 
     WITH_SEMAPHORE(dev_sem);
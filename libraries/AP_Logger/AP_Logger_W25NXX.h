@@ -47,6 +47,8 @@ private:
     uint32_t erase_start_ms;
     uint16_t erase_block;
     bool read_cache_valid;
+    // page loaded into the internal buffer ahead of a sequential read, zero for none
+    uint32_t prefetch_page;
 };
 
 #endif // HAL_LOGGING_FLASH_W25NXX_ENABLED
@@ -66,3 +66,11 @@
 
 #include <AP_Rally/AP_Rally_config.h>
 #define HAL_LOGGER_RALLY_ENABLED HAL_LOGGING_ENABLED && HAL_RALLY_ENABLED
+
+#ifndef AP_LOGGER_DROP_STATS_ENABLED
+#define AP_LOGGER_DROP_STATS_ENABLED HAL_LOGGING_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
+
+#ifndef AP_LOGGER_FILE_COMPRESSION_ENABLED
+#define AP_LOGGER_FILE_COMPRESSION_ENABLED HAL_LOGGING_FILESYSTEM_ENABLED && HAL_PROGRAM_SIZE_LIMIT_KB > 1024
+#endif
@@ -232,6 +232,16 @@ struct PACKED log_DSF {
     uint32_t buf_space_min;
     uint32_t buf_space_max;
     uint32_t buf_space_avg;
+    uint32_t comp_in;
+    uint32_t comp_out;
+    uint32_t comp_us;
+};
+
+struct PACKED log_DSFD {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t msg_type;
+    uint16_t count;
 };
 
 struct PACKED log_Event {
@@ -739,6 +749,15 @@ struct PACKED log_VER {
 // @Field: FMn: Minimum free space in write buffer in last time period
 // @Field: FMx: Maximum free space in write buffer in last time period
 // @Field: FAv: Average free space in write buffer in last time period
+// @Field: CIn: Bytes passed to log compression in last time period
+// @Field: COut: Bytes produced by log compression in last time period
+// @Field: CUs: Time spent compressing log data in last time period
+
+// @LoggerMessage: DSFD
+// @Description: Onboard logging messages dropped because the write buffer was full, by message type
+// @Field: TimeUS: Time since system startup
+// @Field: Type: Message type ID which was dropped, see the FMT message with this type
+// @Field: Cnt: Number of messages of this type dropped in last time period
 
 // @LoggerMessage: ERR
 // @Description: Specifically coded error messages
@@ -1257,7 +1276,9 @@ LOG_STRUCTURE_FROM_HAL \
 LOG_STRUCTURE_FROM_RPM \
 LOG_STRUCTURE_FROM_FENCE \
     { LOG_DF_FILE_STATS, sizeof(log_DSF), \
-      "DSF", "QIHIIII", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv", "s--b---", "F--0---" }, \
+      "DSF", "QIHIIIIIII", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv,CIn,COut,CUs", "s--b---bbs", "F--0---00F" }, \
+    { LOG_DF_DROP_STATS, sizeof(log_DSFD), \
+      "DSFD", "QBH", "TimeUS,Type,Cnt", "s--", "F--" }, \
     { LOG_RALLY_MSG, sizeof(log_Rally), \
       "RALY", "QBBLLhB", "TimeUS,Tot,Seq,Lat,Lng,Alt,Flags", "s--DUm-", "F--GG0-" },  \
     { LOG_MAV_MSG, sizeof(log_MAV),   \
@@ -1379,6 +1400,7 @@ enum LogMessages : uint8_t {
     LOG_RCOUT3_MSG,
     LOG_IDS_FROM_FENCE,
     LOG_IDS_FROM_HAL,
+    LOG_DF_DROP_STATS,
 
     _LOG_LAST_MSG_
 };
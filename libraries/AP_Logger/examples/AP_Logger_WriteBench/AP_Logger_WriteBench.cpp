@@ -0,0 +1,127 @@
+/*
+ * Compare the cost of writing a message with AP_Logger::Write(),
+ * which resolves the format by name and packs the arguments from the
+ * format string, against WriteBlock() of a pre-packed structure
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Scheduler/AP_Scheduler.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define NUM_WRITES 10000
+
+struct PACKED log_BNCH {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float    a;
+    float    b;
+    float    c;
+    int32_t  d;
+    uint8_t  e;
+};
+
+enum MyLogMessages {
+    LOG_BNCH_MSG,
+};
+
+static const struct LogStructure log_structure[] = {
+    { LOG_FORMAT_MSG,
+      sizeof(log_Format),
+      "FMT",
+      "BBnNZ",
+      "Type,Length,Name,Format,Columns",
+      "-b---",
+      "-----" },
+    { LOG_BNCH_MSG,
+      sizeof(log_BNCH),
+      "BNCH",
+      "QfffiB",
+      "TimeUS,A,B,C,D,E",
+      "s-----",
+      "F-----" },
+};
+
+class AP_LoggerTest_WriteBench : public AP_HAL::HAL::Callbacks {
+public:
+    void setup() override;
+    void loop() override;
+
+private:
+
+    AP_Int32 log_bitmask;
+    AP_Logger logger;
+    AP_Scheduler scheduler;
+
+    void bench_write();
+    void bench_writeblock();
+};
+
+void AP_LoggerTest_WriteBench::bench_write()
+{
+    // a few named messages so the lookup is not trivially the first entry
+    logger.Write("BNA", "TimeUS,V", "Qf", AP_HAL::micros64(), 1.0f);
+    logger.Write("BNB", "TimeUS,V", "Qf", AP_HAL::micros64(), 2.0f);
+
+    const uint32_t start_us = AP_HAL::micros();
+    for (uint32_t i=0; i<NUM_WRITES; i++) {
+        logger.Write("BNCN", "TimeUS,A,B,C,D,E", "QfffiB",
+                     AP_HAL::micros64(),
+                     1.5f,
+                     2.5f,
+                     3.5f,
+                     int32_t(i),
+                     uint8_t(i));
+    }
+    const uint32_t dt_us = AP_HAL::micros() - start_us;
+    hal.console->printf("Write():      %.3f us/msg\n", (double)(dt_us / float(NUM_WRITES)));
+}
+
+void AP_LoggerTest_WriteBench::bench_writeblock()
+{
+    const uint32_t start_us = AP_HAL::micros();
+    for (uint32_t i=0; i<NUM_WRITES; i++) {
+        const struct log_BNCH pkt {
+            LOG_PACKET_HEADER_INIT(LOG_BNCH_MSG),
+            time_us : AP_HAL::micros64(),
+            a : 1.5f,
+            b : 2.5f,
+            c : 3.5f,
+            d : int32_t(i),
+            e : uint8_t(i),
+        };
+        logger.WriteBlock(&pkt, sizeof(pkt));
+    }
+    const uint32_t dt_us = AP_HAL::micros() - start_us;
+    hal.console->printf("WriteBlock(): %.3f us/msg\n", (double)(dt_us / float(NUM_WRITES)));
+}
+
+void AP_LoggerTest_WriteBench::setup(void)
+{
+    hal.console->printf("Logger Write benchmark\n");
+
+    log_bitmask.set((uint32_t)-1);
+    logger.init(log_bitmask, log_structure, ARRAY_SIZE(log_structure));
+    logger.set_vehicle_armed(true);
+    logger.Write_Message("AP_Logger Write benchmark");
+
+    hal.scheduler->delay(20);
+
+    bench_write();
+    bench_writeblock();
+
+    logger.StopLogging();
+}
+
+void AP_LoggerTest_WriteBench::loop(void)
+{
+    hal.scheduler->delay(1000);
+}
+
+GCS_Dummy _gcs;
+
+static AP_LoggerTest_WriteBench loggertest;
+
+AP_HAL_MAIN_CALLBACKS(&loggertest);
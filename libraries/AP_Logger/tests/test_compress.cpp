@@ -0,0 +1,171 @@
+#include <AP_gtest.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Logger/AP_Logger_Compress.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_LOGGER_FILE_COMPRESSION_ENABLED
+
+#include <string.h>
+
+static uint16_t hash_table[LOG_COMPRESS_HASH_SIZE];
+static uint8_t comp[LOG_COMPRESS_BOUND(UINT16_MAX)];
+static uint8_t decomp[UINT16_MAX];
+
+// deterministic pseudo-random bytes
+static void fill_random(uint8_t *buf, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        buf[i] = seed >> 24;
+    }
+}
+
+// compress and decompress len bytes, returning the compressed length
+static uint16_t round_trip(const uint8_t *in, uint16_t len)
+{
+    const uint16_t comp_len = log_compress_block(in, len, comp, sizeof(comp), hash_table);
+    EXPECT_GT(comp_len, 0);
+    EXPECT_LE(comp_len, LOG_COMPRESS_BOUND(uint32_t(len)));
+    memset(decomp, 0xAA, sizeof(decomp));
+    EXPECT_EQ(int32_t(len), log_decompress_block(comp, comp_len, decomp, sizeof(decomp)));
+    EXPECT_EQ(0, memcmp(in, decomp, len));
+    return comp_len;
+}
+
+TEST(LogCompress, Random)
+{
+    static uint8_t buf[8192];
+    for (uint32_t seed = 1; seed < 20; seed++) {
+        fill_random(buf, sizeof(buf), seed);
+        const uint16_t comp_len = round_trip(buf, sizeof(buf));
+        // random data cannot compress
+        EXPECT_GE(comp_len, sizeof(buf));
+    }
+}
+
+TEST(LogCompress, Repetitive)
+{
+    static uint8_t buf[8192];
+
+    memset(buf, 0, sizeof(buf));
+    EXPECT_LT(round_trip(buf, sizeof(buf)), sizeof(buf)/50);
+
+    // a short pattern which repeats at an odd period, giving matches
+    // which overlap their own output
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = "abcdefg"[i % 7];
+    }
+    EXPECT_LT(round_trip(buf, sizeof(buf)), sizeof(buf)/50);
+
+    // log-like data: fixed headers with slowly changing payloads
+    for (uint32_t i = 0; i < sizeof(buf); i += 16) {
+        const uint8_t msg[16] { 0xA3, 0x95, 0x42, uint8_t(i>>4), uint8_t(i>>12), 0, 0, 0,
+                                1, 2, 3, 4, uint8_t(i>>6), 0, 0, 0 };
+        memcpy(&buf[i], msg, sizeof(msg));
+    }
+    EXPECT_LT(round_trip(buf, sizeof(buf)), sizeof(buf)/2);
+}
+
+TEST(LogCompress, Incompressible)
+{
+    static uint8_t buf[UINT16_MAX];
+
+    // the largest block whose worst case still fits a frame header
+    uint16_t max_len = UINT16_MAX;
+    while (LOG_COMPRESS_BOUND(uint32_t(max_len)) > UINT16_MAX) {
+        max_len--;
+    }
+    fill_random(buf, max_len, 42);
+    const uint16_t comp_len = round_trip(buf, max_len);
+    EXPECT_LE(comp_len, LOG_COMPRESS_BOUND(uint32_t(max_len)));
+
+    // one byte more could overflow the header length field
+    EXPECT_EQ(0, log_compress_block(buf, max_len+1, comp, sizeof(comp), hash_table));
+}
+
+TEST(LogCompress, ShortBlocks)
+{
+    // blocks around the minimum match and last literal limits
+    uint8_t buf[32];
+    for (uint16_t len = 0; len <= sizeof(buf); len++) {
+        memset(buf, 'x', len);
+        round_trip(buf, len);
+        fill_random(buf, len, len);
+        round_trip(buf, len);
+    }
+}
+
+TEST(LogCompress, MatchAtEnd)
+{
+    // a match running up to the end of the block must stop before
+    // the trailing literals
+    static uint8_t buf[4096];
+    for (uint16_t len = 100; len < 140; len++) {
+        fill_random(buf, 64, 7);
+        for (uint16_t i = 64; i < len; i++) {
+            buf[i] = buf[i - 64];
+        }
+        round_trip(buf, len);
+    }
+}
+
+TEST(LogCompress, FrameBoundaries)
+{
+    // the file backend compresses each write chunk on its own, so a
+    // stream split at any point must rebuild from its frames
+    static uint8_t buf[16384];
+    static uint8_t out[sizeof(buf)];
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (i % 97 < 50) ? uint8_t(i / 97) : uint8_t(i);
+    }
+    const uint16_t chunks[] { 1, 5, 12, 13, 511, 512, 4096, 4097 };
+    for (const uint16_t chunk : chunks) {
+        uint32_t out_len = 0;
+        for (uint32_t ofs = 0; ofs < sizeof(buf); ofs += chunk) {
+            const uint16_t len = MIN(uint32_t(chunk), sizeof(buf) - ofs);
+            const uint16_t comp_len = log_compress_block(&buf[ofs], len, comp, sizeof(comp), hash_table);
+            ASSERT_GT(comp_len, 0);
+            const int32_t n = log_decompress_block(comp, comp_len, &out[out_len], sizeof(out) - out_len);
+            ASSERT_EQ(int32_t(len), n);
+            out_len += n;
+        }
+        EXPECT_EQ(sizeof(buf), out_len);
+        EXPECT_EQ(0, memcmp(buf, out, sizeof(buf)));
+    }
+}
+
+TEST(LogCompress, CorruptBlocks)
+{
+    static uint8_t buf[4096];
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = "logdata"[i % 7];
+    }
+    const uint16_t comp_len = log_compress_block(buf, sizeof(buf), comp, sizeof(comp), hash_table);
+    ASSERT_GT(comp_len, 0);
+
+    // output too small for the block
+    EXPECT_EQ(-1, log_decompress_block(comp, comp_len, decomp, sizeof(buf) - 1));
+
+    // truncated inside a match offset or length
+    for (uint16_t len = 1; len < comp_len; len++) {
+        const int32_t n = log_decompress_block(comp, len, decomp, sizeof(decomp));
+        EXPECT_TRUE(n == -1 || (n >= 0 && n < int32_t(sizeof(buf))));
+    }
+
+    // a match offset reaching before the start of the output
+    const uint8_t bad_offset[] { 0x14, 'a', 0x05, 0x00 };
+    EXPECT_EQ(-1, log_decompress_block(bad_offset, sizeof(bad_offset), decomp, sizeof(decomp)));
+
+    // a zero match offset
+    const uint8_t zero_offset[] { 0x14, 'a', 0x00, 0x00 };
+    EXPECT_EQ(-1, log_decompress_block(zero_offset, sizeof(zero_offset), decomp, sizeof(decomp)));
+
+    // a literal run longer than the block
+    const uint8_t long_literals[] { 0x50, 'a', 'b' };
+    EXPECT_EQ(-1, log_decompress_block(long_literals, sizeof(long_literals), decomp, sizeof(decomp)));
+}
+
+#endif // AP_LOGGER_FILE_COMPRESSION_ENABLED
+
+AP_GTEST_MAIN()
@@ -52,6 +52,7 @@ void SCurve::init()
     time = 0.0f;
     num_segs = SEG_INIT;
     add_segment(num_segs, 0.0f, SegmentType::CONSTANT_JERK, 0.0f, 0.0f, 0.0f, 0.0f);
+    seg_cursor = 0;
 
     is_arc_segment = false;
     seg_delta.zero();
@@ -609,6 +610,31 @@ void SCurve::move_from_time_pos_vel_accel(float time_now, Vector3p &pos, Vector3
     project_scurve_onto_track(scurve_A1, scurve_V1, scurve_P1, pos, vel, accel);
 }
 
+// sample the whole path at intervals of dt seconds, the final sample is at the end of the path
+// pos and vel are filled with the position relative to the origin and the velocity
+// returns the number of samples written which is at most max_samples
+uint16_t SCurve::sample_track(float dt, Vector3p *pos, Vector3f *vel, uint16_t max_samples)
+{
+    if (!is_positive(dt) || max_samples == 0) {
+        return 0;
+    }
+    const float t_end = time_end();
+    uint16_t count = 0;
+    while (count < max_samples) {
+        const float t = count * dt;
+        const bool last = t >= t_end;
+        Vector3f accel;
+        pos[count].zero();
+        vel[count].zero();
+        move_from_time_pos_vel_accel(last ? t_end : t, pos[count], vel[count], accel);
+        count++;
+        if (last) {
+            break;
+        }
+    }
+    return count;
+}
+
 // project the straight-line S-curve motion profile onto the active track segment
 // converts scalar S-curve kinematics (A1, V1, P1) into 3D position, velocity and acceleration
 // along either a circular arc or straight segment
@@ -726,6 +752,30 @@ void SCurve::advance_time(float dt)
     time = MIN(time+dt, time_end());
 }
 
+// find the active segment at time_now, the first segment ending after time_now
+// returns num_segs if time_now is beyond the end of the last segment
+// the result is cached as callers almost always step forward through time
+uint8_t SCurve::find_segment(float time_now) const
+{
+    // check the cached segment and the one after it before searching
+    for (uint8_t pnt = seg_cursor; pnt <= MIN(uint8_t(seg_cursor + 1), num_segs); pnt++) {
+        if ((pnt == 0 || time_now >= segment[pnt - 1].end_time) &&
+            (pnt == num_segs || time_now < segment[pnt].end_time)) {
+            seg_cursor = pnt;
+            return pnt;
+        }
+    }
+
+    uint8_t pnt = num_segs;
+    for (uint8_t i = 0; i < num_segs; i++) {
+        if (time_now < segment[num_segs - 1 - i].end_time) {
+            pnt = num_segs - 1 - i;
+        }
+    }
+    seg_cursor = pnt;
+    return pnt;
+}
+
 // calculate the jerk, acceleration, velocity and position at the provided time
 void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float &At_out, float &Vt_out, float &Pt_out) const
 {
@@ -739,15 +789,9 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
     }
 
     SegmentType Jtype;
-    uint8_t pnt = num_segs;
+    uint8_t pnt = find_segment(time_now);
     float Jm, tj, T0, A0, V0, P0;
 
-    // find active segment at time_now
-    for (uint8_t i = 0; i < num_segs; i++) {
-        if (time_now < segment[num_segs - 1 - i].end_time) {
-            pnt = num_segs - 1 - i;
-        }
-    }
     if (pnt == 0) {
         Jtype = SegmentType::CONSTANT_JERK;
         Jm = 0.0f;
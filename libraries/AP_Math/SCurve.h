@@ -94,6 +94,11 @@ public:
     // this is an internal function, static for test suite
     static void calculate_path(float Sm, float Jm, float V0, float Am, float Vm, float L, float &Jm_out, float &tj_out, float &t2_out, float &t4_out, float &t6_out);
 
+    // sample the whole path at intervals of dt seconds for path previews and planners
+    // pos is relative to the origin, the final sample is at the end of the path
+    // returns the number of samples written to pos and vel, at most max_samples
+    uint16_t sample_track(float dt, Vector3p *pos, Vector3f *vel, uint16_t max_samples);
+
 private:
 
     // increment time and return the position, velocity and acceleration vectors relative to the origin
@@ -149,6 +154,9 @@ private:
     // calculate the jerk, acceleration, velocity and position at time t
     void get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float &At_out, float &Vt_out, float &Pt_out) const;
 
+    // find the active segment at time t, using the cached segment from the previous call as a starting point
+    uint8_t find_segment(float time_now) const;
+
     // calculate the jerk, acceleration, velocity and position at time t when running the constant jerk time segment
     void calc_javp_for_segment_const_jerk(float time_now, float J0, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
 
@@ -214,6 +222,7 @@ private:
     const static uint8_t segments_max = 23; // maximum number of time segments
 
     uint8_t num_segs;       // number of time segments being used
+    mutable uint8_t seg_cursor; // active segment found by the last call to find_segment
     struct {
         float jerk_ref;     // jerk reference value for time segment (the jerk at the beginning, middle or end depending upon the segment type)
         SegmentType seg_type;   // segment type (jerk is constant, increasing or decreasing)
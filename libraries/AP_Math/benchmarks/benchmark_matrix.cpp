@@ -21,4 +21,64 @@ static void BM_MatrixMultiplication(benchmark::State& state)
 
 BENCHMARK(BM_MatrixMultiplication);
 
+// fill a symmetric positive definite matrix of the form JTJ + I
+static void fill_spd_matrix(float *A, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; i++) {
+        for (uint8_t j = 0; j < n; j++) {
+            float sum = (i == j) ? 1.0f : 0.0f;
+            for (uint8_t k = 0; k < n; k++) {
+                sum += sinf(k*n + i) * sinf(k*n + j);
+            }
+            A[i*n+j] = sum;
+        }
+    }
+}
+
+static void BM_MatrixInverse(benchmark::State& state)
+{
+    const uint8_t n = state.range(0);
+    float A[24*24], inv[24*24];
+    fill_spd_matrix(A, n);
+
+    while (state.KeepRunning()) {
+        bool ok = mat_inverse(A, inv, n);
+        gbenchmark_escape(&ok);
+        gbenchmark_escape(inv);
+    }
+}
+
+BENCHMARK(BM_MatrixInverse)->Arg(3)->Arg(4)->Arg(6)->Arg(9)->Arg(24);
+
+static void BM_MatrixInverseSym(benchmark::State& state)
+{
+    const uint8_t n = state.range(0);
+    float A[24*24], inv[24*24];
+    fill_spd_matrix(A, n);
+
+    while (state.KeepRunning()) {
+        memcpy(inv, A, sizeof(float)*n*n);
+        bool ok = mat_inverse_sym(inv, n);
+        gbenchmark_escape(&ok);
+        gbenchmark_escape(inv);
+    }
+}
+
+BENCHMARK(BM_MatrixInverseSym)->Arg(3)->Arg(4)->Arg(6)->Arg(9)->Arg(24);
+
+static void BM_MatrixMultiplicationN(benchmark::State& state)
+{
+    const uint8_t n = state.range(0);
+    float A[24*24], B[24*24], C[24*24];
+    fill_spd_matrix(A, n);
+    fill_spd_matrix(B, n);
+
+    while (state.KeepRunning()) {
+        mat_mul(A, B, C, n);
+        gbenchmark_escape(C);
+    }
+}
+
+BENCHMARK(BM_MatrixMultiplicationN)->Arg(3)->Arg(4)->Arg(6)->Arg(9)->Arg(24);
+
 BENCHMARK_MAIN();
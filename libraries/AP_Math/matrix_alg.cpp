@@ -438,6 +438,89 @@ bool mat_inverse(const T x[], T y[], uint16_t dim)
     }
 }
 
+// square root in the precision of the matrix type
+static inline float sqrt_T(float v)
+{
+    return sqrtf(v);
+}
+static inline double sqrt_T(double v)
+{
+    return sqrt(v);
+}
+
+/*
+ *    in-place inverse of a symmetric positive definite matrix using a
+ *    Cholesky decomposition. This is suitable for the normal equations
+ *    (JTJ) of least squares fits and needs no temporary storage, unlike
+ *    the generic LU based inverse which allocates five nxn matrices
+ *
+ *    @param     A,     input nxn matrix, replaced with its inverse
+ *    @param     n,     dimension of square matrix
+ *    @returns          false = matrix is not positive definite, true = matrix inversion successful
+ */
+template<typename T>
+bool mat_inverse_sym(T *A, uint16_t n)
+{
+    // Cholesky decomposition A = L*L', L stored in the lower triangle
+    for (uint16_t j = 0; j < n; j++) {
+        T d = A[j*n+j];
+        for (uint16_t k = 0; k < j; k++) {
+            d -= A[j*n+k] * A[j*n+k];
+        }
+        if (!(d > 0) || isinf(d)) {
+            return false;
+        }
+        const T ljj = sqrt_T(d);
+        A[j*n+j] = ljj;
+        const T inv_ljj = 1 / ljj;
+        for (uint16_t i = j+1; i < n; i++) {
+            T sum = A[i*n+j];
+            for (uint16_t k = 0; k < j; k++) {
+                sum -= A[i*n+k] * A[j*n+k];
+            }
+            A[i*n+j] = sum * inv_ljj;
+        }
+    }
+
+    // invert L in place, column by column. Entries of L to the right
+    // of the current column are still unmodified
+    for (uint16_t j = 0; j < n; j++) {
+        A[j*n+j] = 1 / A[j*n+j];
+        for (uint16_t i = j+1; i < n; i++) {
+            T sum = A[i*n+j] * A[j*n+j];
+            for (uint16_t k = j+1; k < i; k++) {
+                sum += A[i*n+k] * A[k*n+j];
+            }
+            A[i*n+j] = -sum / A[i*n+i];
+        }
+    }
+
+    // inv(A) = inv(L)' * inv(L), built in the upper triangle which
+    // only overwrites elements of inv(L) that are no longer needed
+    for (uint16_t i = 0; i < n; i++) {
+        for (uint16_t j = i; j < n; j++) {
+            T sum = 0;
+            for (uint16_t k = j; k < n; k++) {
+                sum += A[k*n+i] * A[k*n+j];
+            }
+            A[i*n+j] = sum;
+        }
+    }
+    for (uint16_t i = 1; i < n; i++) {
+        for (uint16_t j = 0; j < i; j++) {
+            A[i*n+j] = A[j*n+i];
+        }
+    }
+
+    //check sanity of results
+    for (uint16_t i = 0; i < n*n; i++) {
+        if (isnan(A[i]) || isinf(A[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename T>
 void mat_mul(const T *A, const T *B, T *C, uint16_t n)
 {
@@ -461,9 +544,11 @@ void mat_identity(T *A, uint16_t n)
 }
 
 template bool mat_inverse<float>(const float x[], float y[], uint16_t dim);
+template bool mat_inverse_sym<float>(float *A, uint16_t n);
 template void mat_mul<float>(const float *A, const float *B, float *C, uint16_t n);
 template void mat_identity<float>(float x[], uint16_t dim);
 
 template bool mat_inverse<double>(const double x[], double y[], uint16_t dim);
+template bool mat_inverse_sym<double>(double *A, uint16_t n);
 template void mat_mul<double>(const double *A, const double *B, double *C, uint16_t n);
 template void mat_identity<double>(double x[], uint16_t dim);
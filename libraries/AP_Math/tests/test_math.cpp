@@ -719,6 +719,37 @@ TEST(MathTest, div1000)
     }
 }
 
+TEST(MathTest, MatInverseSym)
+{
+    // build symmetric positive definite matrices as JTJ plus a damping term
+    for (uint8_t n : {2, 4, 6, 9}) {
+        float A[81], Ainv[81], LU_inv[81], I[81];
+        for (uint8_t i = 0; i < n; i++) {
+            for (uint8_t j = 0; j < n; j++) {
+                float sum = (i == j) ? 0.1f : 0.0f;
+                for (uint8_t k = 0; k < 20; k++) {
+                    sum += sinf(k*n + i) * sinf(k*n + j);
+                }
+                A[i*n+j] = sum;
+            }
+        }
+        memcpy(Ainv, A, sizeof(A));
+        EXPECT_TRUE(mat_inverse_sym(Ainv, n));
+        EXPECT_TRUE(mat_inverse(A, LU_inv, n));
+        mat_mul(A, Ainv, I, n);
+        for (uint8_t i = 0; i < n; i++) {
+            for (uint8_t j = 0; j < n; j++) {
+                EXPECT_NEAR(I[i*n+j], (i == j) ? 1.0f : 0.0f, 1.0e-3f);
+                EXPECT_NEAR(Ainv[i*n+j], LU_inv[i*n+j], 1.0e-3f * fabsf(LU_inv[i*n+j]) + 1.0e-4f);
+            }
+        }
+    }
+
+    // indefinite matrices are rejected
+    float B[4] { 1, 2, 2, 1 };
+    EXPECT_FALSE(mat_inverse_sym(B, 2));
+}
+
 AP_GTEST_PANIC()
 AP_GTEST_MAIN()
 
@@ -17,6 +17,30 @@ TEST(LinesScurve, test_calculate_path)
     EXPECT_FLOAT_EQ(t6_out, 0.25000018);
 }
 
+TEST(LinesScurve, test_sample_track)
+{
+    SCurve scurve;
+    scurve.calculate_track(Vector3p{0, 0, 0}, Vector3p{100, 0, 0}, 0,
+                           10, 2.5, 1.5, 5, 2.5, 5, 62.8319, 10);
+
+    Vector3p pos[200];
+    Vector3f vel[200];
+    const uint16_t n = scurve.sample_track(0.1, pos, vel, ARRAY_SIZE(pos));
+    ASSERT_GT(n, 2);
+    ASSERT_LT(n, ARRAY_SIZE(pos));
+
+    // path starts at the origin, moves forward and ends stopped at the destination
+    EXPECT_NEAR(pos[0].x, 0, 1.0e-3);
+    for (uint16_t i = 1; i < n; i++) {
+        EXPECT_GE(pos[i].x, pos[i-1].x);
+        EXPECT_LE(vel[i].x, 10.0001);
+    }
+    EXPECT_NEAR(pos[n-1].x, 100, 1.0e-2);
+    EXPECT_NEAR(vel[n-1].x, 0, 1.0e-2);
+
+    // a short buffer is filled without overrunning
+    EXPECT_EQ(scurve.sample_track(0.1, pos, vel, 5), 5);
+}
 
 AP_GTEST_MAIN()
 int hal = 0; //weirdly the build will fail without this
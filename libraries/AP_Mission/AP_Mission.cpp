@@ -87,6 +87,9 @@ void AP_Mission::init()
         _cmd_total.set(0);
     }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    cmd_cache_init();
+#endif
 
     // check_eeprom_version - checks version of missions stored in eeprom matches this library
     // command list will be cleared if they do not match
@@ -832,6 +835,12 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    if (cmd_cache_get(index, cmd)) {
+        return true;
+    }
+#endif
+
     // ensure all bytes of cmd are zeroed
     cmd = {};
 
@@ -890,10 +899,108 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    cmd_cache_set(index, cmd);
+#endif
+
     // return success
     return true;
 }
 
+/// read_cmd_range - read up to count commands starting at start_index into cmds
+///     returns the number of commands read
+uint16_t AP_Mission::read_cmd_range(uint16_t start_index, Mission_Command *cmds, uint16_t count) const
+{
+    WITH_SEMAPHORE(_rsem);
+
+    uint16_t i;
+    for (i=0; i<count; i++) {
+        if (!read_cmd_from_storage(start_index+i, cmds[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+/// write_cmd_range - write count commands to storage starting at start_index
+///     start_index must be no greater than num_commands(); the mission is extended if required
+///     true is returned if all commands were written
+bool AP_Mission::write_cmd_range(uint16_t start_index, const Mission_Command *cmds, uint16_t count)
+{
+    WITH_SEMAPHORE(_rsem);
+
+    if (start_index > (unsigned)_cmd_total ||
+        uint32_t(start_index) + count > num_commands_max()) {
+        return false;
+    }
+
+    for (uint16_t i=0; i<count; i++) {
+        if (!write_cmd_to_storage(start_index+i, cmds[i])) {
+            return false;
+        }
+    }
+
+    // extend the mission once rather than per item to save on
+    // parameter writes
+    if (start_index + count > _cmd_total) {
+        _cmd_total.set_and_save(start_index + count);
+    }
+
+    return true;
+}
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+// allocate the decoded command cache.  Failure to allocate is not
+// fatal, commands are then always read from storage
+void AP_Mission::cmd_cache_init()
+{
+    if (_cmd_cache != nullptr || _commands_max == 0) {
+        return;
+    }
+    _cmd_cache_valid = NEW_NOTHROW uint32_t[(_commands_max+31U)/32U];
+    if (_cmd_cache_valid == nullptr) {
+        return;
+    }
+    _cmd_cache = NEW_NOTHROW Mission_Command[_commands_max];
+    if (_cmd_cache == nullptr) {
+        delete[] _cmd_cache_valid;
+        _cmd_cache_valid = nullptr;
+        return;
+    }
+    memset(_cmd_cache_valid, 0, sizeof(uint32_t)*((_commands_max+31U)/32U));
+}
+
+// fill in cmd from the cache, returns false if it is not cached
+bool AP_Mission::cmd_cache_get(uint16_t index, Mission_Command &cmd) const
+{
+    if (_cmd_cache == nullptr || index >= _commands_max) {
+        return false;
+    }
+    if ((_cmd_cache_valid[index/32U] & (1U<<(index%32U))) == 0) {
+        return false;
+    }
+    cmd = _cmd_cache[index];
+    return true;
+}
+
+void AP_Mission::cmd_cache_set(uint16_t index, const Mission_Command &cmd) const
+{
+    if (_cmd_cache == nullptr || index >= _commands_max) {
+        return;
+    }
+    _cmd_cache[index] = cmd;
+    _cmd_cache_valid[index/32U] |= (1U<<(index%32U));
+}
+
+void AP_Mission::cmd_cache_invalidate(uint16_t index)
+{
+    if (_cmd_cache == nullptr || index >= _commands_max) {
+        return;
+    }
+    _cmd_cache_valid[index/32U] &= ~(1U<<(index%32U));
+}
+#endif  // AP_MISSION_CMD_CACHE_ENABLED
+
 bool AP_Mission::stored_in_location(uint16_t id)
 {
     switch (id) {
@@ -961,6 +1068,11 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         memcpy(packed.bytes, &cmd.content, 12);
     }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // the decoded form will be re-read from storage on next access
+    cmd_cache_invalidate(index);
+#endif
+
     // calculate where in storage the command should be placed
     uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
 
@@ -2951,6 +3063,15 @@ const char *AP_Mission::Mission_Command::type() const
  */
 uint16_t AP_Mission::get_command_id(uint16_t index) const
 {
+#if AP_MISSION_CMD_CACHE_ENABLED
+    {
+        WITH_SEMAPHORE(_rsem);
+        Mission_Command cmd;
+        if (cmd_cache_get(index, cmd)) {
+            return cmd.id;
+        }
+    }
+#endif
     const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
     uint8_t b[3] {};
     if (!_storage.read_block(b, pos_in_storage, sizeof(b))) {
@@ -61,6 +61,7 @@ union PackedContent;
 /// @brief    Object managing Mission
 class AP_Mission
 {
+    friend class AP_Mission_Test;
 
 public:
     // jump command structure
@@ -516,6 +517,15 @@ public:
         return _commands_max;
     }
 
+    /// read_cmd_range - read up to count commands starting at start_index into cmds
+    ///     returns the number of commands read
+    uint16_t read_cmd_range(uint16_t start_index, Mission_Command *cmds, uint16_t count) const;
+
+    /// write_cmd_range - write count commands to storage starting at start_index
+    ///     start_index must be no greater than num_commands(); the mission is extended if required
+    ///     true is returned if all commands were written
+    bool write_cmd_range(uint16_t start_index, const Mission_Command *cmds, uint16_t count);
+
     // Present - returns true if there is a mission currently loaded, ignoring home which is stored in index 0
     bool present() const { return _cmd_total > 1; }
 
@@ -939,6 +949,18 @@ private:
     // fast call to get command ID of a mission index
     uint16_t get_command_id(uint16_t index) const;
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // decoded copy of the commands in storage, indexed by command
+    // index.  An entry is only used if its bit in _cmd_cache_valid is
+    // set; writes to storage clear the bit.  Accessed with _rsem held
+    mutable Mission_Command *_cmd_cache;  // nullptr if not allocated
+    mutable uint32_t *_cmd_cache_valid;
+    void cmd_cache_init();
+    bool cmd_cache_get(uint16_t index, Mission_Command &cmd) const;
+    void cmd_cache_set(uint16_t index, const Mission_Command &cmd) const;
+    void cmd_cache_invalidate(uint16_t index);
+#endif
+
     // memoisation of contains-relative:
     bool _contains_terrain_alt_items;  // true if the mission has terrain-relative items
     uint32_t _last_contains_relative_calculated_ms;  // will be equal to _last_change_time_ms if _contains_terrain_alt_items is up-to-date
@@ -7,3 +7,9 @@
 #ifndef AP_MISSION_NAV_PAYLOAD_PLACE_ENABLED
 #define AP_MISSION_NAV_PAYLOAD_PLACE_ENABLED 1
 #endif
+
+// keep an in-RAM copy of decoded mission commands so repeated reads
+// don't have to unpack them from storage
+#ifndef AP_MISSION_CMD_CACHE_ENABLED
+#define AP_MISSION_CMD_CACHE_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
@@ -0,0 +1,255 @@
+#include <AP_gtest.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Mission/AP_Mission.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+
+#include <string.h>
+
+class AP_Mission_Test
+{
+public:
+    // start from an empty mission holding just the home slot, so
+    // commands can be written without an AHRS for home
+    void reset()
+    {
+        if (!initialised) {
+            mission.init();
+            initialised = true;
+        }
+        mission.clear();
+        mission._cmd_total.set(1);
+    }
+
+    bool cached(uint16_t index) const
+    {
+        AP_Mission::Mission_Command cmd;
+        WITH_SEMAPHORE(mission._rsem);
+        return mission.cmd_cache_get(index, cmd);
+    }
+
+    // decode a command from storage, bypassing the cache
+    bool read_uncached(uint16_t index, AP_Mission::Mission_Command &cmd)
+    {
+        WITH_SEMAPHORE(mission._rsem);
+        mission.cmd_cache_invalidate(index);
+        return mission.read_cmd_from_storage(index, cmd);
+    }
+
+    uint16_t get_command_id(uint16_t index) const
+    {
+        return mission.get_command_id(index);
+    }
+
+    bool cache_allocated() const
+    {
+        return mission._cmd_cache != nullptr;
+    }
+
+    AP_Mission mission{
+        FUNCTOR_BIND_MEMBER(&AP_Mission_Test::start_cmd, bool, const AP_Mission::Mission_Command &),
+        FUNCTOR_BIND_MEMBER(&AP_Mission_Test::verify_cmd, bool, const AP_Mission::Mission_Command &),
+        FUNCTOR_BIND_MEMBER(&AP_Mission_Test::mission_complete, void)};
+
+private:
+    bool start_cmd(const AP_Mission::Mission_Command &cmd) { return true; }
+    bool verify_cmd(const AP_Mission::Mission_Command &cmd) { return true; }
+    void mission_complete(void) {}
+
+    bool initialised;
+};
+
+// AP_Mission is a singleton, so all tests share one instance
+static AP_Mission_Test mission_test;
+
+static AP_Mission::Mission_Command waypoint(int32_t lat, int32_t lng, int32_t alt_cm)
+{
+    AP_Mission::Mission_Command cmd {};
+    cmd.id = MAV_CMD_NAV_WAYPOINT;
+    cmd.content.location = Location{lat, lng, alt_cm, Location::AltFrame::ABOVE_HOME};
+    return cmd;
+}
+
+static void expect_waypoint(uint16_t index, const AP_Mission::Mission_Command &expected)
+{
+    AP_Mission::Mission_Command cmd;
+    ASSERT_TRUE(mission_test.mission.read_cmd_from_storage(index, cmd));
+    EXPECT_EQ(index, cmd.index);
+    EXPECT_EQ(expected.id, cmd.id);
+    EXPECT_EQ(expected.content.location.lat, cmd.content.location.lat);
+    EXPECT_EQ(expected.content.location.lng, cmd.content.location.lng);
+    EXPECT_EQ(expected.content.location.alt, cmd.content.location.alt);
+}
+
+TEST(AP_Mission_Cache, FilledOnRead)
+{
+    mission_test.reset();
+    ASSERT_TRUE(mission_test.cache_allocated());
+
+    const AP_Mission::Mission_Command cmds[] {
+        waypoint(-353632610, 1491652300, 1000),
+        waypoint(-353632620, 1491652310, 2000),
+        waypoint(-353632630, 1491652320, 3000),
+    };
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(1, cmds, ARRAY_SIZE(cmds)));
+    EXPECT_EQ(4, mission_test.mission.num_commands());
+
+    for (uint16_t i=1; i<=ARRAY_SIZE(cmds); i++) {
+        // writes leave nothing cached
+        EXPECT_FALSE(mission_test.cached(i));
+        expect_waypoint(i, cmds[i-1]);
+        EXPECT_TRUE(mission_test.cached(i));
+        // the second read comes from the cache
+        expect_waypoint(i, cmds[i-1]);
+        EXPECT_EQ(MAV_CMD_NAV_WAYPOINT, mission_test.get_command_id(i));
+    }
+}
+
+TEST(AP_Mission_Cache, MatchesStorage)
+{
+    mission_test.reset();
+
+    AP_Mission::Mission_Command cmds[4] {};
+    cmds[0] = waypoint(-353632610, 1491652300, 1000);
+    cmds[1].id = MAV_CMD_DO_JUMP;
+    cmds[1].content.jump.target = 1;
+    cmds[1].content.jump.num_times = 3;
+    cmds[2].id = MAV_CMD_CONDITION_DELAY;
+    cmds[2].content.delay.seconds = 12;
+    cmds[3].id = MAV_CMD_DO_SET_SERVO;
+    cmds[3].content.servo.channel = 9;
+    cmds[3].content.servo.pwm = 1700;
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(1, cmds, ARRAY_SIZE(cmds)));
+
+    // a cached command must be identical to a fresh decode
+    for (uint16_t i=1; i<=ARRAY_SIZE(cmds); i++) {
+        AP_Mission::Mission_Command from_cache, from_storage;
+        ASSERT_TRUE(mission_test.mission.read_cmd_from_storage(i, from_cache));
+        ASSERT_TRUE(mission_test.mission.read_cmd_from_storage(i, from_cache));
+        ASSERT_TRUE(mission_test.cached(i));
+        ASSERT_TRUE(mission_test.read_uncached(i, from_storage));
+        EXPECT_EQ(from_storage.index, from_cache.index);
+        EXPECT_EQ(from_storage.id, from_cache.id);
+        EXPECT_EQ(from_storage.p1, from_cache.p1);
+        EXPECT_EQ(0, memcmp(&from_storage.content, &from_cache.content, sizeof(from_cache.content)));
+    }
+}
+
+TEST(AP_Mission_Cache, ReplaceInvalidates)
+{
+    mission_test.reset();
+
+    const AP_Mission::Mission_Command cmds[] {
+        waypoint(-353632610, 1491652300, 1000),
+        waypoint(-353632620, 1491652310, 2000),
+    };
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(1, cmds, ARRAY_SIZE(cmds)));
+    expect_waypoint(2, cmds[1]);
+    ASSERT_TRUE(mission_test.cached(2));
+
+    // replacing a cached command must not leave the old one behind,
+    // including when the command type changes
+    AP_Mission::Mission_Command delay {};
+    delay.id = MAV_CMD_CONDITION_DELAY;
+    delay.content.delay.seconds = 5;
+    ASSERT_TRUE(mission_test.mission.replace_cmd(2, delay));
+    EXPECT_FALSE(mission_test.cached(2));
+    EXPECT_EQ(MAV_CMD_CONDITION_DELAY, mission_test.get_command_id(2));
+
+    AP_Mission::Mission_Command cmd;
+    ASSERT_TRUE(mission_test.mission.read_cmd_from_storage(2, cmd));
+    EXPECT_EQ(MAV_CMD_CONDITION_DELAY, cmd.id);
+    EXPECT_FLOAT_EQ(5, cmd.content.delay.seconds);
+
+    // neighbouring entries are unaffected
+    expect_waypoint(1, cmds[0]);
+}
+
+TEST(AP_Mission_Cache, RangeWriteInvalidates)
+{
+    mission_test.reset();
+
+    const AP_Mission::Mission_Command first[] {
+        waypoint(-353632610, 1491652300, 1000),
+        waypoint(-353632620, 1491652310, 2000),
+        waypoint(-353632630, 1491652320, 3000),
+    };
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(1, first, ARRAY_SIZE(first)));
+
+    AP_Mission::Mission_Command read[ARRAY_SIZE(first)];
+    ASSERT_EQ(ARRAY_SIZE(first), mission_test.mission.read_cmd_range(1, read, ARRAY_SIZE(read)));
+    for (uint16_t i=1; i<=ARRAY_SIZE(first); i++) {
+        ASSERT_TRUE(mission_test.cached(i));
+    }
+
+    // overwrite the last two and extend the mission by one
+    const AP_Mission::Mission_Command second[] {
+        waypoint(-353632700, 1491652400, 4000),
+        waypoint(-353632710, 1491652410, 5000),
+        waypoint(-353632720, 1491652420, 6000),
+    };
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(2, second, ARRAY_SIZE(second)));
+    EXPECT_EQ(5, mission_test.mission.num_commands());
+    EXPECT_TRUE(mission_test.cached(1));
+    EXPECT_FALSE(mission_test.cached(2));
+    EXPECT_FALSE(mission_test.cached(3));
+
+    expect_waypoint(1, first[0]);
+    for (uint16_t i=0; i<ARRAY_SIZE(second); i++) {
+        expect_waypoint(2+i, second[i]);
+    }
+}
+
+TEST(AP_Mission_Cache, StaleAfterTruncate)
+{
+    mission_test.reset();
+
+    const AP_Mission::Mission_Command cmds[] {
+        waypoint(-353632610, 1491652300, 1000),
+        waypoint(-353632620, 1491652310, 2000),
+        waypoint(-353632630, 1491652320, 3000),
+    };
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(1, cmds, ARRAY_SIZE(cmds)));
+    expect_waypoint(3, cmds[2]);
+    ASSERT_TRUE(mission_test.cached(3));
+
+    // a truncated command can't be read even though it is still cached
+    mission_test.mission.truncate(2);
+    AP_Mission::Mission_Command cmd;
+    EXPECT_FALSE(mission_test.mission.read_cmd_from_storage(3, cmd));
+
+    // growing the mission again must return the new command, not the
+    // one cached before the truncate
+    const AP_Mission::Mission_Command regrow[] {
+        waypoint(-353632800, 1491652500, 7000),
+        waypoint(-353632810, 1491652510, 8000),
+    };
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(2, regrow, ARRAY_SIZE(regrow)));
+    expect_waypoint(2, regrow[0]);
+    expect_waypoint(3, regrow[1]);
+}
+
+TEST(AP_Mission_Cache, RangeLimits)
+{
+    mission_test.reset();
+
+    const AP_Mission::Mission_Command cmd = waypoint(-353632610, 1491652300, 1000);
+
+    // can't leave a gap after the end of the mission
+    EXPECT_FALSE(mission_test.mission.write_cmd_range(3, &cmd, 1));
+    EXPECT_FALSE(mission_test.cached(3));
+
+    // can't write beyond the storage
+    EXPECT_FALSE(mission_test.mission.write_cmd_range(1, &cmd, mission_test.mission.num_commands_max()));
+
+    // reads stop at the end of the mission
+    ASSERT_TRUE(mission_test.mission.write_cmd_range(1, &cmd, 1));
+    AP_Mission::Mission_Command read[3];
+    EXPECT_EQ(1, mission_test.mission.read_cmd_range(1, read, ARRAY_SIZE(read)));
+}
+
+#endif // AP_MISSION_CMD_CACHE_ENABLED
+
+AP_GTEST_MAIN()
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+#include <AP_Vehicle/AP_Vehicle_Type.h>
+
+// EKF cores may run on worker threads, each thread then needs its own
+// copy of the scratch space shared between cores
+#ifndef AP_NAVEKF_CORE_THREADS_ENABLED
+#define AP_NAVEKF_CORE_THREADS_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL) && !APM_BUILD_TYPE(APM_BUILD_AP_DAL_Standalone)
+#endif
@@ -16,8 +16,13 @@
  */
 #include "AP_NavEKF_core_common.h"
 
+#if AP_NAVEKF_CORE_THREADS_ENABLED
+thread_local NavEKF_core_common::Matrix24 NavEKF_core_common::KHP;
+thread_local NavEKF_core_common::Vector28 NavEKF_core_common::Kfusion;
+#else
 NavEKF_core_common::Matrix24 NavEKF_core_common::KHP;
 NavEKF_core_common::Vector28 NavEKF_core_common::Kfusion;
+#endif
 
 /*
   fill common scratch variables, for detecting re-use of variables between loops in SITL
@@ -20,6 +20,7 @@
 #include <AP_Math/AP_Math.h>
 #include <AP_Math/vectorN.h>
 #include "AP_Nav_Common.h"
+#include "AP_NavEKF_config.h"
 
 /*
   this declares a common parent class for AP_NavEKF2 and
@@ -30,6 +31,9 @@
   we also save a lot of CPU (approx 10% on STM32F427) as the compiler
   is able to resolve the address of these variables at compile time,
   which means significantly faster code
+
+  When cores can run on worker threads each thread gets its own copy
+  of the scratch space
  */
 class NavEKF_core_common {
 public:
@@ -42,8 +46,13 @@ public:
 #endif
 
 protected:
+#if AP_NAVEKF_CORE_THREADS_ENABLED
+    static thread_local Matrix24 KHP;     // intermediate result used for covariance updates
+    static thread_local Vector28 Kfusion; // intermediate fusion vector
+#else
     static Matrix24 KHP;                  // intermediate result used for covariance updates
     static Vector28 Kfusion;              // intermediate fusion vector
+#endif
 
     // fill all the common scratch variables with NaN on SITL
     void fill_scratch_variables(void);
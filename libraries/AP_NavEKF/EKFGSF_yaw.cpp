@@ -91,6 +91,33 @@ void EKFGSF_yaw::update(const Vector3F &delAng,
         accel_gain = 0.0f;
     }
 
+    // Calculate the AHRS inputs which are the same for every model so
+    // they are only computed once per update rather than per model
+
+    // Calculate angular rate vector in rad/sec averaged across last sample interval
+    ang_rate_delayed_raw = delta_angle / angle_dt;
+
+    if (accel_gain > 0.0f) {
+        tilt_accel = ahrs_accel;
+
+        if (is_positive(true_airspeed)) {
+            // Calculate centripetal acceleration in body frame from cross product of body rate and body frame airspeed vector
+            // NOTE: this assumes X axis is aligned with airspeed vector
+            const Vector3F centripetal_accel_vec_bf {
+                0.0f,
+                ang_rate_delayed_raw[2] * true_airspeed,
+                - ang_rate_delayed_raw[1] * true_airspeed
+            };
+            // Correct measured accel for centripetal acceleration
+            tilt_accel -= centripetal_accel_vec_bf;
+        }
+
+        tilt_accel_gain = accel_gain / ahrs_accel_norm;
+    }
+
+    // only learn gyro bias when not spinning quickly
+    learn_gyro_bias = ang_rate_delayed_raw.length_squared() < sq(0.175f);
+
     // Always run the AHRS prediction cycle for each model
     for (uint8_t mdl_idx = 0; mdl_idx < N_MODELS_EKFGSF; mdl_idx++) {
         predict(mdl_idx);
@@ -198,38 +225,18 @@ void EKFGSF_yaw::predictAHRS(const uint8_t mdl_idx)
     // Calculate 'k' unit vector of earth frame rotated into body frame
     const Vector3F k{AHRS[mdl_idx].R[2][0], AHRS[mdl_idx].R[2][1], AHRS[mdl_idx].R[2][2]};
 
-    // Calculate angular rate vector in rad/sec averaged across last sample interval
-    const Vector3F ang_rate_delayed_raw { delta_angle / angle_dt };
-
     // Perform angular rate correction using accel data and reduce correction as accel magnitude moves away from 1 g (reduces drift when vehicle picked up and moved).
-    // During fixed wing flight, compensate for centripetal acceleration assuming coordinated turns and X axis forward
+    // During fixed wing flight, tilt_accel has been compensated for centripetal acceleration assuming coordinated turns and X axis forward
 
     Vector3F tilt_error_gyro_correction; // (rad/sec)
 
     if (accel_gain > 0.0f) {
-
-        Vector3F accel = ahrs_accel;
-
-        if (is_positive(true_airspeed)) {
-            // Calculate centripetal acceleration in body frame from cross product of body rate and body frame airspeed vector
-            // NOTE: this assumes X axis is aligned with airspeed vector
-            const Vector3F centripetal_accel_vec_bf {
-                0.0f,
-                ang_rate_delayed_raw[2] * true_airspeed,
-                - ang_rate_delayed_raw[1] * true_airspeed
-            };
-            // Correct measured accel for centripetal acceleration
-            accel -= centripetal_accel_vec_bf;
-        }
-
-        tilt_error_gyro_correction = (k % accel) * (accel_gain / ahrs_accel_norm);
-
+        tilt_error_gyro_correction = (k % tilt_accel) * tilt_accel_gain;
     }
 
     // Gyro bias estimation
     const ftype gyro_bias_limit = radians(5.0f);
-    const ftype spinRate_squared = ang_rate_delayed_raw.length_squared();
-    if (spinRate_squared < sq(0.175f)) {
+    if (learn_gyro_bias) {
         AHRS[mdl_idx].gyro_bias -= tilt_error_gyro_correction * (EKFGSF_gyroBiasGain * angle_dt);
 
         // sanity check
@@ -335,9 +342,11 @@ void EKFGSF_yaw::predict(const uint8_t mdl_idx)
     }
 
     // calculate delta velocity in a horizontal front-right frame
+    const ftype t2 = sinF(EKF[mdl_idx].X[2]);
+    const ftype t3 = cosF(EKF[mdl_idx].X[2]);
     const Vector3F del_vel_NED = AHRS[mdl_idx].R * delta_velocity;
-    const ftype dvx =   del_vel_NED[0] * cosF(EKF[mdl_idx].X[2]) + del_vel_NED[1] * sinF(EKF[mdl_idx].X[2]);
-    const ftype dvy = - del_vel_NED[0] * sinF(EKF[mdl_idx].X[2]) + del_vel_NED[1] * cosF(EKF[mdl_idx].X[2]);
+    const ftype dvx =   del_vel_NED[0] * t3 + del_vel_NED[1] * t2;
+    const ftype dvy = - del_vel_NED[0] * t2 + del_vel_NED[1] * t3;
 
     // sum delta velocities in earth frame:
     EKF[mdl_idx].X[0] += del_vel_NED[0];
@@ -362,8 +371,6 @@ void EKFGSF_yaw::predict(const uint8_t mdl_idx)
     const ftype dvyVar = dvxVar; // variance of right delta velocity - (m/s)^2
     const ftype dazVar = sq(EKFGSF_gyroNoise * angle_dt); // variance of yaw delta angle - rad^2
 
-    const ftype t2 = sinF(EKF[mdl_idx].X[2]);
-    const ftype t3 = cosF(EKF[mdl_idx].X[2]);
     const ftype t4 = dvy*t3;
     const ftype t5 = dvx*t2;
     const ftype t6 = t4+t5;
@@ -87,6 +87,10 @@ private:
     Vector3F ahrs_accel;            // filtered body frame specific force vector used by AHRS calculation (m/s/s)
     ftype ahrs_accel_norm;          // length of body frame specific force vector used by AHRS calculation (m/s/s)
     ftype true_airspeed;            // true airspeed used to correct for centripetal acceleratoin in coordinated turns (m/s)
+    Vector3F ang_rate_delayed_raw;  // angular rate vector averaged across last sample interval (rad/sec)
+    Vector3F tilt_accel;            // ahrs_accel corrected for centripetal acceleration, used for tilt correction by all models (m/s/s)
+    ftype tilt_accel_gain;          // gain from tilt_accel cross product to rate gyro correction (1/sec per m/s/s)
+    bool learn_gyro_bias;           // true when the spin rate is low enough for the models to learn gyro bias
 
     // Runs quaternion prediction for the selected AHRS using IMU (and optionally true airspeed) data
     void predictAHRS(const uint8_t mdl_idx);
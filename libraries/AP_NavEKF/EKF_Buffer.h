@@ -39,6 +39,11 @@ public:
     // zeroes all data in the ring buffer
     void reset();
 
+    // return true if the buffer has been allocated
+    bool is_allocated() const {
+        return buffer != nullptr;
+    }
+
 private:
     const uint8_t elsize;
     void *buffer;
@@ -86,6 +91,10 @@ public:
     void reset() {
         return ekf_ring_buffer::reset();
     }
+
+    bool is_allocated() const {
+        return ekf_ring_buffer::is_allocated();
+    }
 };
 
 
@@ -161,7 +170,7 @@ public:
       Writes data to a Ring buffer and advances indices that
      define the location of the newest and oldest data
     */
-    void push_youngest_element(element_type element) {
+    void push_youngest_element(const element_type &element) {
         return ekf_imu_buffer::push_youngest_element(&element);
     }
 
@@ -177,8 +186,14 @@ public:
         return ret;
     }
 
+    // retrieve the oldest data from the ring buffer tail directly
+    // into the caller's storage, avoiding a temporary copy
+    void get_oldest_element(element_type &ret) {
+        ekf_imu_buffer::get_oldest_element(&ret);
+    }
+
     // writes the same data to all elements in the ring buffer
-    void reset_history(element_type element) {
+    void reset_history(const element_type &element) {
         ekf_imu_buffer::reset_history(&element);
     }
 
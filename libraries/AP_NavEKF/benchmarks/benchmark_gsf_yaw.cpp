@@ -0,0 +1,51 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_NavEKF/EKFGSF_yaw.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const ftype DT = 0.0025;
+
+// level, stationary IMU sample at 400Hz with a small turn rate
+static const Vector3F del_ang{0.0001 * DT, -0.0002 * DT, 0.05 * DT};
+static const Vector3F del_vel{0.0, 0.0, -GRAVITY_MSS * DT};
+
+// align the AHRS tilt and start velocity fusion so the full bank runs
+static void setup_gsf(EKFGSF_yaw &gsf)
+{
+    gsf.update(del_ang, del_vel, DT, DT, true, 0);
+    gsf.update(del_ang, del_vel, DT, DT, true, 0);
+    gsf.fuseVelData(Vector2F{1.0, 0.5}, 0.5);
+}
+
+// cost of the prediction for all models, run on every EKF3 predict step
+static void BM_GSFYawUpdate(benchmark::State& state)
+{
+    EKFGSF_yaw gsf;
+    setup_gsf(gsf);
+
+    while (state.KeepRunning()) {
+        gsf.update(del_ang, del_vel, DT, DT, true, state.range(0));
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_GSFYawUpdate)->Arg(0)->Arg(20);
+
+// cost of a velocity fusion for all models, run at the GPS rate
+static void BM_GSFYawFuseVel(benchmark::State& state)
+{
+    EKFGSF_yaw gsf;
+    setup_gsf(gsf);
+
+    while (state.KeepRunning()) {
+        gsf.update(del_ang, del_vel, DT, DT, true, 0);
+        gsf.fuseVelData(Vector2F{1.0, 0.5}, 0.5);
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_GSFYawFuseVel);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_NavEKF/EKF_Buffer.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// same layout as the EKF3 imu_elements
+struct imu_elements {
+    Vector3F    delAng;
+    Vector3F    delVel;
+    ftype       delAngDT;
+    ftype       delVelDT;
+    uint32_t    time_ms;
+    uint8_t     gyro_index;
+    uint8_t     accel_index;
+};
+
+// EKF3 stores 100 IMU samples at 400Hz
+static const uint8_t IMU_BUFFER_LENGTH = 100;
+
+static void BM_IMUBufferOldestByValue(benchmark::State& state)
+{
+    EKF_IMU_buffer_t<imu_elements> buf;
+    buf.init(IMU_BUFFER_LENGTH);
+    imu_elements e {};
+    imu_elements delayed;
+
+    while (state.KeepRunning()) {
+        e.time_ms++;
+        buf.push_youngest_element(e);
+        delayed = buf.get_oldest_element();
+        gbenchmark_escape(&delayed);
+    }
+}
+
+BENCHMARK(BM_IMUBufferOldestByValue);
+
+static void BM_IMUBufferOldestInPlace(benchmark::State& state)
+{
+    EKF_IMU_buffer_t<imu_elements> buf;
+    buf.init(IMU_BUFFER_LENGTH);
+    imu_elements e {};
+    imu_elements delayed;
+
+    while (state.KeepRunning()) {
+        e.time_ms++;
+        buf.push_youngest_element(e);
+        buf.get_oldest_element(delayed);
+        gbenchmark_escape(&delayed);
+    }
+}
+
+BENCHMARK(BM_IMUBufferOldestInPlace);
+
+// cost of the per sample down-sampling done in NavEKF3_core::readIMUData()
+static void BM_IMUDownSample(benchmark::State& state)
+{
+    QuaternionF q;
+    Vector3F delVel;
+    const Vector3F delAng{0.001, -0.002, 0.0005};
+    const Vector3F dv{0.01, 0.02, -0.0245};
+
+    while (state.KeepRunning()) {
+        q.rotate(delAng);
+        q.normalize();
+        Matrix3F deltaRotMat;
+        q.rotation_matrix(deltaRotMat);
+        delVel += deltaRotMat*dv;
+        gbenchmark_escape(&delVel);
+    }
+}
+
+BENCHMARK(BM_IMUDownSample);
+
+BENCHMARK_MAIN();
@@ -122,6 +122,25 @@ TEST(EKF_Buffer, EKF_Buffer)
     EXPECT_FALSE(buf.recall(d2, 103));
 }
 
+TEST(EKF_Buffer, is_allocated)
+{
+    struct test_data : EKF_obs_element_t {
+        uint32_t data;
+    };
+    EKF_obs_buffer_t<test_data> buf;
+    EXPECT_FALSE(buf.is_allocated());
+
+    // an unallocated buffer ignores pushes and holds no data
+    struct test_data d, d2;
+    d.data = 17;
+    d.time_ms = 100;
+    buf.push(d);
+    EXPECT_FALSE(buf.recall(d2, 101));
+
+    EXPECT_TRUE(buf.init(8));
+    EXPECT_TRUE(buf.is_allocated());
+}
+
 TEST(ekf_imu_buffer, one_element_case)
 {
     // test degenerate 1-element case:
@@ -176,6 +195,41 @@ TEST(ekf_imu_buffer, is_filled)
     EXPECT_EQ(b->is_filled(), true);
 }
 
+TEST(EKF_IMU_buffer, oldest_element)
+{
+    struct element {
+        float delAng[3];
+        uint32_t time_ms;
+    };
+    EKF_IMU_buffer_t<element> buf;
+    EXPECT_TRUE(buf.init(4));
+
+    element e {};
+    for (uint8_t i=0; i<10; i++) {
+        e.delAng[0] = i;
+        e.time_ms = 100+i;
+        buf.push_youngest_element(e);
+        if (i < 3) {
+            continue;
+        }
+        // the in-place and by-value variants must agree and
+        // lag the youngest element by the buffer length
+        element oldest;
+        buf.get_oldest_element(oldest);
+        const element oldest2 = buf.get_oldest_element();
+        EXPECT_EQ(oldest.time_ms, uint32_t(100+i-3));
+        EXPECT_EQ(oldest.time_ms, oldest2.time_ms);
+        EXPECT_FLOAT_EQ(oldest.delAng[0], i-3);
+    }
+    EXPECT_TRUE(buf.is_filled());
+
+    e.time_ms = 7;
+    buf.reset_history(e);
+    element oldest;
+    buf.get_oldest_element(oldest);
+    EXPECT_EQ(oldest.time_ms, 7U);
+}
+
 AP_GTEST_MAIN()
 
 #endif // HAL_SITL or HAL_LINUX
@@ -445,7 +445,7 @@ void NavEKF2_core::readIMUData()
         runUpdates = true;
 
         // extract the oldest available data from the FIFO buffer
-        imuDataDelayed = storedIMU.get_oldest_element();
+        storedIMU.get_oldest_element(imuDataDelayed);
 
         // protect against delta time going to zero
         // TODO - check if calculations can tolerate 0
@@ -13,6 +13,8 @@
 
 #include <new>
 
+extern const AP_HAL::HAL& hal;
+
 /*
   parameter defaults for different types of vehicle. The
   APM_BUILD_DIRECTORY is taken from the main vehicle directory name
@@ -664,7 +666,7 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
 
     // @Param: DRAG_BCOEF_X
     // @DisplayName: Ballistic coefficient for X axis drag
-    // @Description: Ratio of mass to drag coefficient measured along the X body axis. This parameter enables estimation of wind drift for vehicles with bluff bodies and without propulsion forces in the X and Y direction (eg multicopters). The drag produced by this effect scales with speed squared. Set to a positive value > 1.0 to enable. A starting value is the mass in Kg divided by the frontal area. The predicted drag from the rotors is specified separately by the EK3_DRAG_MCOEF parameter.
+    // @Description: Ratio of mass to drag coefficient measured along the X body axis. This parameter enables estimation of wind drift for vehicles with bluff bodies and without propulsion forces in the X and Y direction (eg multicopters). The drag produced by this effect scales with speed squared. Set to a positive value > 1.0 to enable. A starting value is the mass in Kg divided by the frontal area. The predicted drag from the rotors is specified separately by the EK3_DRAG_MCOEF parameter. Enabling drag fusion when all drag coefficients were zero at boot requires a reboot.
     // @Range: 0.0 1000.0
     // @Units: kg/m/m
     // @User: Advanced
@@ -672,7 +674,7 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
 
     // @Param: DRAG_BCOEF_Y
     // @DisplayName: Ballistic coefficient for Y axis drag
-    // @Description: Ratio of mass to drag coefficient measured along the Y body axis. This parameter enables estimation of wind drift for vehicles with bluff bodies and without propulsion forces in the X and Y direction (eg multicopters). The drag produced by this effect scales with speed squared. Set to a positive value > 1.0 to enable. A starting value is the mass in Kg divided by the side area. The predicted drag from the rotors is specified separately by the EK3_DRAG_MCOEF parameter.
+    // @Description: Ratio of mass to drag coefficient measured along the Y body axis. This parameter enables estimation of wind drift for vehicles with bluff bodies and without propulsion forces in the X and Y direction (eg multicopters). The drag produced by this effect scales with speed squared. Set to a positive value > 1.0 to enable. A starting value is the mass in Kg divided by the side area. The predicted drag from the rotors is specified separately by the EK3_DRAG_MCOEF parameter. Enabling drag fusion when all drag coefficients were zero at boot requires a reboot.
     // @Range: 50.0 1000.0
     // @Units: kg/m/m
     // @User: Advanced
@@ -689,7 +691,7 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
 
     // @Param: DRAG_MCOEF
     // @DisplayName: Momentum coefficient for propeller drag
-    // @Description: This parameter is used to predict the drag produced by the rotors when flying a multi-copter, enabling estimation of wind drift. The drag produced by this effect scales with speed not speed squared and is produced because some of the air velocity normal to the rotors axis of rotation is lost when passing through the rotor disc which changes the momentum of the airflow causing drag. For unducted rotors the effect is roughly proportional to the area of the propeller blades when viewed side on and changes with different propellers. It is higher for ducted rotors. For example if flying at 15 m/s at sea level conditions produces a rotor induced drag acceleration of 1.5 m/s/s, then EK3_DRAG_MCOEF would be set to 0.1 = (1.5/15.0). Set EK3_MCOEF to a positive value to enable wind estimation using this drag effect. To account for the drag produced by the body which scales with speed squared, see documentation for the EK3_DRAG_BCOEF_X and EK3_DRAG_BCOEF_Y parameters.
+    // @Description: This parameter is used to predict the drag produced by the rotors when flying a multi-copter, enabling estimation of wind drift. The drag produced by this effect scales with speed not speed squared and is produced because some of the air velocity normal to the rotors axis of rotation is lost when passing through the rotor disc which changes the momentum of the airflow causing drag. For unducted rotors the effect is roughly proportional to the area of the propeller blades when viewed side on and changes with different propellers. It is higher for ducted rotors. For example if flying at 15 m/s at sea level conditions produces a rotor induced drag acceleration of 1.5 m/s/s, then EK3_DRAG_MCOEF would be set to 0.1 = (1.5/15.0). Set EK3_MCOEF to a positive value to enable wind estimation using this drag effect. To account for the drag produced by the body which scales with speed squared, see documentation for the EK3_DRAG_BCOEF_X and EK3_DRAG_BCOEF_Y parameters. Enabling drag fusion when all drag coefficients were zero at boot requires a reboot.
     // @Range: 0.0 1.0
     // @Increment: 0.01
     // @Units: 1/s
@@ -739,8 +741,8 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
 
     // @Param: OPTIONS
     // @DisplayName: Optional EKF behaviour
-    // @Description: EKF optional behaviour. Bit 0 (JammingExpected): Setting JammingExpected will change the EKF behaviour such that if dead reckoning navigation is possible it will require the preflight alignment GPS quality checks controlled by EK3_GPS_CHECK and EK3_CHECK_SCALE to pass before resuming GPS use if GPS lock is lost for more than 2 seconds to prevent bad position estimate. Bit 1 (Manual lane switching): DANGEROUS – If enabled, this disables automatic lane switching. If the active lane becomes unhealthy, no automatic switching will occur. Users must manually set EK3_PRIMARY to change lanes. No health checks will be performed on the selected lane. Use with extreme caution.  Bit 2 (Optflow may use terrain alt): Terrain SRTM data will be used if the vehicle climbs above the rangefinder's range allowing optical flow to be used at higher altitudes.
-    // @Bitmask: 0:JammingExpected, 1:ManualLaneSwitching, 2:Optflow may use terrain alt
+    // @Description: EKF optional behaviour. Bit 0 (JammingExpected): Setting JammingExpected will change the EKF behaviour such that if dead reckoning navigation is possible it will require the preflight alignment GPS quality checks controlled by EK3_GPS_CHECK and EK3_CHECK_SCALE to pass before resuming GPS use if GPS lock is lost for more than 2 seconds to prevent bad position estimate. Bit 1 (Manual lane switching): DANGEROUS – If enabled, this disables automatic lane switching. If the active lane becomes unhealthy, no automatic switching will occur. Users must manually set EK3_PRIMARY to change lanes. No health checks will be performed on the selected lane. Use with extreme caution.  Bit 2 (Optflow may use terrain alt): Terrain SRTM data will be used if the vehicle climbs above the rangefinder's range allowing optical flow to be used at higher altitudes. Bit 3 (Threaded lanes): On multi-core Linux boards run each lane after the first on its own thread, in parallel with the main loop. Lanes run in parallel once the EKF origin has been set.
+    // @Bitmask: 0:JammingExpected, 1:ManualLaneSwitching, 2:Optflow may use terrain alt, 3:Threaded lanes
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  11, NavEKF3, _options, 0),
 
@@ -917,19 +919,23 @@ void NavEKF3::UpdateFilter(void)
 
     imuSampleTime_us = dal.micros64();
 
-    for (uint8_t i=0; i<num_cores; i++) {
-        // if we have not overrun by more than 3 IMU frames, and we
-        // have already used more than 1/3 of the CPU budget for this
-        // loop then suppress the prediction step. This allows
-        // multiple EKF instances to cooperate on scheduling
-        bool allow_state_prediction = true;
-        if (core[i].getFramesSincePredict() < (_framesPerPrediction+3) &&
-            dal.ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
-            allow_state_prediction = false;
+#if EK3_FEATURE_LANE_THREADS
+    if (!update_lanes_threaded())
+#endif
+    {
+        for (uint8_t i=0; i<num_cores; i++) {
+            core[i].UpdateFilter(lane_prediction_allowed(i));
         }
-        core[i].UpdateFilter(allow_state_prediction);
     }
 
+#if HAL_LOGGING_ENABLED
+    // lanes hold their own messages back, so they are written from
+    // this thread in lane order whether or not the lanes are threaded
+    for (uint8_t i=0; i<num_cores; i++) {
+        core[i].Log_Write_Pending();
+    }
+#endif
+
     // If the current core selected has a bad error score or is unhealthy, switch to a healthy core with the lowest fault score
     // Don't start running the check until the primary core has started returned healthy for at least 10 seconds to avoid switching
     // due to initial alignment fluctuations and race conditions
@@ -1020,6 +1026,116 @@ void NavEKF3::UpdateFilter(void)
     sources.align_inactive_sources();
 }
 
+/*
+  return true if lane i may run its state prediction on this frame
+ */
+bool NavEKF3::lane_prediction_allowed(uint8_t i)
+{
+    // if we have not overrun by more than 3 IMU frames, and we
+    // have already used more than 1/3 of the CPU budget for this
+    // loop then suppress the prediction step. This allows
+    // multiple EKF instances to cooperate on scheduling
+    if (core[i].getFramesSincePredict() < (_framesPerPrediction+3) &&
+        dal.ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
+        return false;
+    }
+    return true;
+}
+
+#if EK3_FEATURE_LANE_THREADS
+/*
+  the lanes are double precision on the boards with lane threads, and
+  the fusion steps keep their observation Jacobians, gains and the
+  generated intermediate terms on the stack. On top of that a lane
+  may format a GCS_SEND_TEXT. SITL allocates exactly this plus a
+  small fixed margin and panics on overflow, so be generous as memory
+  is not short on these boards
+ */
+#ifndef LANE_THREAD_STACK_SIZE
+#define LANE_THREAD_STACK_SIZE 65536
+#endif
+
+class NavEKF3::LaneWorker {
+public:
+    NavEKF3_core *lane;
+    bool allow_state_prediction;
+    HAL_BinarySemaphore start_sem;
+    HAL_BinarySemaphore done_sem;
+
+    void thread_main(void) {
+        while (true) {
+            if (!start_sem.wait_blocking()) {
+                continue;
+            }
+            lane->UpdateFilter(allow_state_prediction);
+            done_sem.signal();
+        }
+    }
+};
+
+/*
+  create one worker thread for each lane after the first
+ */
+bool NavEKF3::start_lane_threads(void)
+{
+    lane_workers = NEW_NOTHROW LaneWorker[num_cores-1];
+    if (lane_workers == nullptr) {
+        return false;
+    }
+    for (uint8_t i=1; i<num_cores; i++) {
+        LaneWorker &w = lane_workers[i-1];
+        w.lane = &core[i];
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND(&w, &NavEKF3::LaneWorker::thread_main, void),
+                                          "EKF3lane", LANE_THREAD_STACK_SIZE, AP_HAL::Scheduler::PRIORITY_MAIN, 0)) {
+            // threads which did start stay idle waiting on their
+            // semaphore, so the workers are never freed
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+  run the lanes in parallel for this frame. Lane 0 runs in this
+  thread, the others on the worker threads, and we wait for all of
+  them before lane selection. Each lane only reads the DAL frame and
+  its own state, so the results are identical to running the lanes
+  one after the other
+ */
+bool NavEKF3::update_lanes_threaded(void)
+{
+    if (num_cores < 2 || lane_threads_failed || !option_is_enabled(Option::ThreadedLanes)) {
+        return false;
+    }
+    if (!common_origin_valid) {
+        // the first lane to set its origin sets the common origin,
+        // run sequentially until then so the winner is deterministic
+        return false;
+    }
+    if (lane_workers == nullptr && !start_lane_threads()) {
+        lane_threads_failed = true;
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "EKF3: lane threads failed, running sequentially");
+        return false;
+    }
+
+    // the prediction scheduling decisions are made before any lane
+    // runs so they are recorded by the DAL in lane order
+    const bool allow_state_prediction = lane_prediction_allowed(0);
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_workers[i-1].allow_state_prediction = lane_prediction_allowed(i);
+    }
+
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_workers[i-1].start_sem.signal();
+    }
+    core[0].UpdateFilter(allow_state_prediction);
+    for (uint8_t i=1; i<num_cores; i++) {
+        IGNORE_RETURN(lane_workers[i-1].done_sem.wait_blocking());
+    }
+    return true;
+}
+#endif  // EK3_FEATURE_LANE_THREADS
+
 /*
   check if switching lanes will reduce the normalised
   innovations. This is called when the vehicle code is about to
@@ -25,6 +25,8 @@
 #include <AP_NavEKF/AP_Nav_Common.h>
 #include <AP_NavEKF/AP_NavEKF_Source.h>
 
+#include "AP_NavEKF3_feature.h"
+
 class NavEKF3_core;
 class EKFGSF_yaw;
 
@@ -469,6 +471,7 @@ private:
         JammingExpected         = (1<<0),
         ManualLaneSwitch        = (1<<1),
         OptflowMayUseTerrainAlt = (1<<2),
+        ThreadedLanes           = (1<<3),
     };
     bool option_is_enabled(Option option) const {
         return (_options & (uint32_t)option) != 0;
@@ -588,4 +591,22 @@ private:
 
     // position, velocity and yaw source control
     AP_NavEKF_Source sources;
+
+    // return true if lane i may run its state prediction on this frame
+    bool lane_prediction_allowed(uint8_t i);
+
+#if EK3_FEATURE_LANE_THREADS
+    // worker thread running one lane, lane 0 always runs in the
+    // calling thread
+    class LaneWorker;
+    LaneWorker *lane_workers = nullptr;
+    bool lane_threads_failed;
+
+    // create the lane worker threads
+    bool start_lane_threads(void);
+
+    // run all lanes in parallel for this frame, returns false if the
+    // lanes need to be run sequentially
+    bool update_lanes_threaded(void);
+#endif
 };
@@ -453,4 +453,16 @@ void NavEKF3_core::Log_Write_GSF(uint64_t time_us)
     yawEstimator->Log_Write(time_us, LOG_XKY0_MSG, LOG_XKY1_MSG, DAL_CORE(core_index));
 }
 
+void NavEKF3_core::Log_Write_Pending(void)
+{
+    if (pending_XKFM_valid) {
+        AP::logger().WriteBlock(&pending_XKFM, sizeof(pending_XKFM));
+        pending_XKFM_valid = false;
+    }
+    if (pending_XKTV_valid) {
+        AP::logger().WriteBlock(&pending_XKTV, sizeof(pending_XKTV));
+        pending_XKTV_valid = false;
+    }
+}
+
 #endif  // HAL_LOGGING_ENABLED
@@ -514,7 +514,7 @@ void NavEKF3_core::readIMUData(bool startPredictEnabled)
         runUpdates = true;
 
         // extract the oldest available data from the FIFO buffer
-        imuDataDelayed = storedIMU.get_oldest_element();
+        storedIMU.get_oldest_element(imuDataDelayed);
 
         // protect against delta time going to zero
         ftype minDT = 0.1f * dtEkfAvg;
@@ -1457,7 +1457,7 @@ void NavEKF3_core::updateMovementCheck(void)
     if (logStatusChange || imuSampleTime_ms - lastMoveCheckLogTime_ms > 200) {
         lastMoveCheckLogTime_ms = imuSampleTime_ms;
 #if HAL_LOGGING_ENABLED
-        const struct log_XKFM pkt{
+        pending_XKFM = log_XKFM{
             LOG_PACKET_HEADER_INIT(LOG_XKFM_MSG),
             time_us            : dal.micros64(),
             core               : core_index,
@@ -1467,27 +1467,38 @@ void NavEKF3_core::updateMovementCheck(void)
             gyro_diff_ratio    : float(gyro_diff_ratio),
             accel_diff_ratio   : float(accel_diff_ratio),
         };
-        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        pending_XKFM_valid = true;
 #endif
     }
 }
 
+#if EK3_FEATURE_DRAG_FUSION
+bool NavEKF3_core::dragFusionConfigured() const
+{
+    return frontend->_ballisticCoef_x.get() > 1.0f ||
+           frontend->_ballisticCoef_y.get() > 1.0f ||
+           frontend->_momentumDragCoef.get() > 0.001f;
+}
+#endif
+
 void NavEKF3_core::SampleDragData(const imu_elements &imu)
 {
 #if EK3_FEATURE_DRAG_FUSION
     // Average and down sample to 5Hz
-    const ftype bcoef_x = frontend->_ballisticCoef_x.get();
-    const ftype bcoef_y = frontend->_ballisticCoef_y.get();
-    const ftype mcoef = frontend->_momentumDragCoef.get();
-    const bool using_bcoef_x = bcoef_x > 1.0f;
-    const bool using_bcoef_y = bcoef_y > 1.0f;
-    const bool using_mcoef = mcoef > 0.001f;
-    if (!using_bcoef_x && !using_bcoef_y && !using_mcoef) {
+    if (!dragFusionConfigured()) {
         // nothing to do
         dragFusionEnabled = false;
         return;
     }
 
+    // the drag buffer is allocated in setup_core() only if drag
+    // fusion was configured at boot, pre_arm_check() reports the
+    // reboot needed if it was enabled later
+    if (!storedDrag.is_allocated()) {
+        dragFusionEnabled = false;
+        return;
+    }
+
     dragFusionEnabled = true;
 
     // down-sample the drag specific force data by accumulating and calculating the mean when
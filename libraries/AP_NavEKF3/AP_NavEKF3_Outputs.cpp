@@ -53,6 +53,15 @@ bool NavEKF3_core::pre_arm_check(bool requires_position, char *failure_msg, uint
         }
     }
 
+#if EK3_FEATURE_DRAG_FUSION
+    if (dragFusionConfigured() && !storedDrag.is_allocated()) {
+        // drag coefficient set after boot, buffer is only allocated in setup_core()
+        dal.snprintf(failure_msg, failure_msg_len,
+                     "EKF3[%u] drag fusion needs reboot", unsigned(core_index)+1);
+        return false;
+    }
+#endif
+
     // all OK
     return true;
 }
@@ -161,7 +161,8 @@ bool NavEKF3_core::setup_core(uint8_t _imu_index, uint8_t _core_index)
         return false;
     }
 #if EK3_FEATURE_DRAG_FUSION
-    if (!storedDrag.init(obs_buffer_length)) {
+    // the drag buffer is only needed when a drag coefficient is set
+    if (dragFusionConfigured() && !storedDrag.init(obs_buffer_length)) {
         return false;
     }
 #endif
@@ -2230,14 +2231,14 @@ void NavEKF3_core::verifyTiltErrorVariance()
     tiltErrorVarianceAlt = MIN(tiltErrorVarianceAlt, sq(radians(30.0f)));
     if (imuSampleTime_ms - lastLogTime_ms > 500) {
         lastLogTime_ms = imuSampleTime_ms;
-        const struct log_XKTV msg {
+        pending_XKTV = log_XKTV{
             LOG_PACKET_HEADER_INIT(LOG_XKTV_MSG),
             time_us      : dal.micros64(),
             core         : core_index,
             tvs          : float(tiltErrorVariance),
             tvd          : float(tiltErrorVarianceAlt),
         };
-        AP::logger().WriteBlock(&msg, sizeof(msg));
+        pending_XKTV_valid = true;
     }
 #endif  // HAL_LOGGING_ENABLED
 }
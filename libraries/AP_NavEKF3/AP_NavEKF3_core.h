@@ -33,6 +33,8 @@
 #include <AP_NavEKF/EKF_Buffer.h>
 #include <AP_InertialSensor/AP_InertialSensor.h>
 #include <AP_RangeFinder/AP_RangeFinder.h>
+#include <AP_Logger/AP_Logger_config.h>
+#include "LogStructure.h"
 
 #include "AP_NavEKF/EKFGSF_yaw.h"
 
@@ -469,6 +471,10 @@ public:
 
     void Log_Write(uint64_t time_us);
 
+    // write the messages held back by UpdateFilter, which may have
+    // run on a lane thread. Called from the main thread
+    void Log_Write_Pending(void);
+
     // returns true when the state estimates are significantly degraded by vibration
     bool isVibrationAffected() const { return badIMUdata; }
 
@@ -1065,6 +1071,8 @@ private:
     void FuseDragForces();
     void SelectDragFusion();
     void SampleDragData(const imu_elements &imu);
+    // return true if any of the drag coefficients enable drag fusion
+    bool dragFusionConfigured() const;
 
     bool getGPSLLH(Location &loc) const;
 
@@ -1620,6 +1628,15 @@ private:
     uint32_t lastEkfStateVarLogTime_ms;
     uint32_t lastTimingLogTime_ms;
 
+#if HAL_LOGGING_ENABLED
+    // XKFM and XKTV are produced inside UpdateFilter and held here
+    // until Log_Write_Pending()
+    struct log_XKFM pending_XKFM;
+    struct log_XKTV pending_XKTV;
+    bool pending_XKFM_valid;
+    bool pending_XKTV_valid;
+#endif
+
     // bits in EK3_AFFINITY
     enum ekf_affinity {
         EKF_AFFINITY_GPS  = (1U<<0),
@@ -9,6 +9,7 @@
 #include <AP_Beacon/AP_Beacon_config.h>
 #include <AP_AHRS/AP_AHRS_config.h>
 #include <AP_OpticalFlow/AP_OpticalFlow_config.h>
+#include <AP_NavEKF/AP_NavEKF_config.h>
 
 // define for when to include all features
 #define EK3_FEATURE_ALL APM_BUILD_TYPE(APM_BUILD_AP_DAL_Standalone) || APM_BUILD_TYPE(APM_BUILD_Replay)
@@ -51,3 +52,8 @@
 #ifndef EK3_FEATURE_OPTFLOW_SRTM
 #define EK3_FEATURE_OPTFLOW_SRTM EK3_FEATURE_OPTFLOW_FUSION
 #endif
+
+// running lanes on worker threads on multi-core Linux boards
+#ifndef EK3_FEATURE_LANE_THREADS
+#define EK3_FEATURE_LANE_THREADS AP_NAVEKF_CORE_THREADS_ENABLED
+#endif
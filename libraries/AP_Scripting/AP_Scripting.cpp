@@ -73,7 +73,7 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
 
     // @Param: VM_I_COUNT
     // @DisplayName: Scripting Virtual Machine Instruction Count
-    // @Description: The number virtual machine instructions that can be run before considering a script to have taken an excessive amount of time
+    // @Description: The number virtual machine instructions that each script can run each time it is called before it is considered to have taken an excessive amount of time and is stopped
     // @Range: 1000 1000000
     // @Increment: 10000
     // @User: Advanced
@@ -94,7 +94,7 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @Bitmask: 0: No Scripts to run message if all scripts have stopped
     // @Bitmask: 1: Runtime messages for memory usage and execution time
     // @Bitmask: 2: Suppress logging scripts to dataflash
-    // @Bitmask: 3: log runtime memory usage and execution time
+    // @Bitmask: 3: log runtime memory usage and execution time, and per-script run statistics
     // @Bitmask: 4: Disable pre-arm check
     // @Bitmask: 5: Save CRC of current scripts to loaded and running checksum parameters enabling pre-arm
     // @Bitmask: 6: Disable heap expansion on allocation failure
@@ -969,6 +969,22 @@ function Vector3f_ud:angle(v2) end
 ---@param param1 number -- XY rotation in radians
 function Vector3f_ud:rotate_xy(param1) end
 
+-- Add another Vector3f to this one in place, no new userdata is created
+---@param v2 Vector3f_ud
+function Vector3f_ud:add_inplace(v2) end
+
+-- Subtract another Vector3f from this one in place, no new userdata is created
+---@param v2 Vector3f_ud
+function Vector3f_ud:sub_inplace(v2) end
+
+-- Scale this Vector3f in place, no new userdata is created
+---@param scale_factor number
+function Vector3f_ud:scale_inplace(scale_factor) end
+
+-- Copy the contents of another Vector3f into this one, no new userdata is created
+---@param v2 Vector3f_ud
+function Vector3f_ud:copy_from(v2) end
+
 -- return the x and y components of this vector as a Vector2f
 ---@return Vector2f_ud
 function Vector3f_ud:xy() end
@@ -3799,6 +3815,20 @@ function ahrs:get_relative_position_NED_home() end
 ---@return Vector3f_ud|nil -- North, east, down velcoity in meters / second if available
 function ahrs:get_velocity_NED() end
 
+-- Allocation free version of get_velocity_NED, fills the supplied Vector3f rather than creating a new one
+---@param vel_ned Vector3f_ud -- filled with north, east, down velocity in meters / second if available
+---@return boolean -- true if the velocity is available
+function ahrs:get_velocity_NED_into(vel_ned) end
+
+-- Allocation free version of get_relative_position_NED_origin, fills the supplied Vector3f rather than creating a new one
+---@param pos_ned Vector3f_ud -- filled with the north, east, down position from the origin in meters if available
+---@return boolean -- true if the position is available
+function ahrs:get_relative_position_NED_origin_into(pos_ned) end
+
+-- Allocation free version of get_gyro, fills the supplied Vector3f rather than creating a new one
+---@param gyro Vector3f_ud -- filled with the smoothed and filtered gyro rates in radians / second
+function ahrs:get_gyro_into(gyro) end
+
 -- Get current groundspeed vector in meter / second
 ---@return Vector2f_ud -- ground speed vector, North East, meters / second
 function ahrs:groundspeed_vector() end
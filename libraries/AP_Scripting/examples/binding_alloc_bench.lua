@@ -0,0 +1,56 @@
+--[[
+   benchmark comparing the allocating AHRS and Vector3f bindings with
+   their allocation free equivalents. Every ITERATIONS calls of each
+   variant are timed and the average cost per call is sent to the GCS.
+   The allocation free versions also avoid the garbage collector work
+   that the allocating versions cause later on
+--]]
+
+local ITERATIONS = 200
+local RATE_HZ = 1
+
+local MAV_SEVERITY_INFO = 6
+
+local vel = Vector3f()
+local pos = Vector3f()
+local gyro = Vector3f()
+local sum = Vector3f()
+
+-- time a function over ITERATIONS calls, returning microseconds per call
+local function time_call(fn)
+   local t0 = micros()
+   for _ = 1, ITERATIONS do
+      fn()
+   end
+   return (micros() - t0):tofloat() / ITERATIONS
+end
+
+local function alloc_version()
+   local v = ahrs:get_velocity_NED()
+   local p = ahrs:get_relative_position_NED_origin()
+   local g = ahrs:get_gyro()
+   if v and p then
+      sum = (sum + v + p + g):scale(0.5)
+   end
+end
+
+local function inplace_version()
+   local have_vel = ahrs:get_velocity_NED_into(vel)
+   local have_pos = ahrs:get_relative_position_NED_origin_into(pos)
+   ahrs:get_gyro_into(gyro)
+   if have_vel and have_pos then
+      sum:add_inplace(vel)
+      sum:add_inplace(pos)
+      sum:add_inplace(gyro)
+      sum:scale_inplace(0.5)
+   end
+end
+
+function update()
+   local t_alloc = time_call(alloc_version)
+   local t_inplace = time_call(inplace_version)
+   gcs:send_text(MAV_SEVERITY_INFO, string.format("bench: alloc %.1fus inplace %.1fus per call", t_alloc, t_inplace))
+   return update, math.floor(1000 / RATE_HZ)
+end
+
+return update()
@@ -11,6 +11,7 @@
 #include <AP_Logger/AP_Logger.h>
 #include <AP_Filesystem/AP_Filesystem.h>
 #include <AP_GPS/AP_GPS.h>
+#include <AP_AHRS/AP_AHRS.h>
 
 #include "lua_bindings.h"
 
@@ -1257,4 +1258,107 @@ int lua_AP_Vehicle_set_target_velocity_NED(lua_State *L)
 }
 #endif // AP_SCRIPTING_BINDING_VEHICLE_ENABLED
 
+#if AP_AHRS_ENABLED
+/*
+  allocation free AHRS getters. These fill a Vector3f supplied by the
+  script rather than creating a new userdata on every call, so scripts
+  polling the AHRS at a high rate don't generate garbage
+ */
+int lua_AP_AHRS_get_velocity_NED_into(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    AP_AHRS * ud = check_AP_AHRS(L);
+    Vector3f & data_2 = *check_Vector3f(L, 2);
+
+    ud->get_semaphore().take_blocking();
+    const bool data = ud->get_velocity_NED(data_2);
+    ud->get_semaphore().give();
+
+    lua_pushboolean(L, data);
+    return 1;
+}
+
+int lua_AP_AHRS_get_relative_position_NED_origin_into(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    AP_AHRS * ud = check_AP_AHRS(L);
+    Vector3f & data_2 = *check_Vector3f(L, 2);
+
+    ud->get_semaphore().take_blocking();
+    const bool data = ud->get_relative_position_NED_origin_float(data_2);
+    ud->get_semaphore().give();
+
+    lua_pushboolean(L, data);
+    return 1;
+}
+
+int lua_AP_AHRS_get_gyro_into(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    AP_AHRS * ud = check_AP_AHRS(L);
+    Vector3f & data_2 = *check_Vector3f(L, 2);
+
+    ud->get_semaphore().take_blocking();
+    data_2 = ud->get_gyro();
+    ud->get_semaphore().give();
+
+    return 0;
+}
+#endif // AP_AHRS_ENABLED
+
+/*
+  in place Vector3f arithmetic, the result is written to the first
+  vector instead of allocating a new userdata as the operators do
+ */
+int lua_Vector3f_add_inplace(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    Vector3f & ud = *check_Vector3f(L, 1);
+    const Vector3f & data_2 = *check_Vector3f(L, 2);
+
+    ud += data_2;
+
+    return 0;
+}
+
+int lua_Vector3f_sub_inplace(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    Vector3f & ud = *check_Vector3f(L, 1);
+    const Vector3f & data_2 = *check_Vector3f(L, 2);
+
+    ud -= data_2;
+
+    return 0;
+}
+
+int lua_Vector3f_scale_inplace(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    Vector3f & ud = *check_Vector3f(L, 1);
+    const float data_2 = luaL_checknumber(L, 2);
+
+    ud *= data_2;
+
+    return 0;
+}
+
+int lua_Vector3f_copy_from(lua_State *L)
+{
+    binding_argcheck(L, 2);
+
+    Vector3f & ud = *check_Vector3f(L, 1);
+    const Vector3f & data_2 = *check_Vector3f(L, 2);
+
+    ud = data_2;
+
+    return 0;
+}
+
 #endif  // AP_SCRIPTING_ENABLED
@@ -38,3 +38,10 @@ int lua_GCS_command_int(lua_State *L);
 int lua_DroneCAN_get_FlexDebug(lua_State *L);
 int lua_gps_inject_data(lua_State *L);
 int lua_AP_Vehicle_set_target_velocity_NED(lua_State *L);
+int lua_AP_AHRS_get_velocity_NED_into(lua_State *L);
+int lua_AP_AHRS_get_relative_position_NED_origin_into(lua_State *L);
+int lua_AP_AHRS_get_gyro_into(lua_State *L);
+int lua_Vector3f_add_inplace(lua_State *L);
+int lua_Vector3f_sub_inplace(lua_State *L);
+int lua_Vector3f_scale_inplace(lua_State *L);
+int lua_Vector3f_copy_from(lua_State *L);
@@ -21,6 +21,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_Scripting.h"
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Math/crc.h>
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
@@ -159,10 +160,151 @@ void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_me
 #endif // HAL_LOGGING_ENABLED
 }
 
+// state for reading a script from the filesystem while computing its crc32
+struct script_reader {
+    int fd;
+    uint32_t crc;
+    bool first_block;
+    bool in_comment;    // blanking a leading '#' line
+    bool read_error;
+    char buf[256];
+};
+
+static const char *script_reader_read(lua_State *L, void *ud, size_t *size) {
+    (void)L;
+    script_reader &r = *(script_reader *)ud;
+    const int32_t n = AP::FS().read(r.fd, r.buf, sizeof(r.buf));
+    if (n <= 0) {
+        r.read_error = (n < 0);
+        return nullptr;
+    }
+    r.crc = crc_crc32(r.crc, (const uint8_t *)r.buf, n);
+
+    int32_t ofs = 0;
+    if (r.first_block) {
+        r.first_block = false;
+        // skip UTF-8 BOM, and treat a leading '#' line as a comment as luaL_loadfile does
+        if (n >= 3 && memcmp(r.buf, "\xEF\xBB\xBF", 3) == 0) {
+            ofs = 3;
+        }
+        r.in_comment = (ofs < n) && (r.buf[ofs] == '#');
+    }
+    // blank the comment rather than dropping it so line numbers are kept
+    for (int32_t i = ofs; r.in_comment && i < n; i++) {
+        if (r.buf[i] == '\n') {
+            r.in_comment = false;
+        } else {
+            r.buf[i] = ' ';
+        }
+    }
+
+    *size = n - ofs;
+    return &r.buf[ofs];
+}
+
+/*
+  load a script as a Lua chunk, like luaL_loadfile(), and compute the
+  crc32 of the file in the same pass rather than reading it twice
+ */
+static int load_script_file(lua_State *L, const char *filename, uint32_t &crc) {
+    script_reader r {};
+    r.first_block = true;
+    r.fd = AP::FS().open(filename, O_RDONLY);
+    if (r.fd == -1) {
+        lua_pushfstring(L, "cannot open %s", filename);
+        return LUA_ERRFILE;
+    }
+
+    lua_pushfstring(L, "@%s", filename);
+    const int chunkname = lua_gettop(L);
+    const int status = lua_load(L, script_reader_read, &r, lua_tostring(L, chunkname), "t");
+    AP::FS().close(r.fd);
+    if (r.read_error) {
+        lua_settop(L, chunkname - 1);
+        lua_pushfstring(L, "cannot read %s", filename);
+        return LUA_ERRFILE;
+    }
+    lua_remove(L, chunkname);
+    crc = r.crc;
+    return status;
+}
+
+#ifndef SCRIPT_STATS_LOG_INTERVAL_MS
+#define SCRIPT_STATS_LOG_INTERVAL_MS 10000
+#endif
+
+void lua_scripts::update_script_stats(script_info *script, uint32_t run_time_us, uint32_t late_ms)
+{
+    script_stats &stats = script->stats;
+    stats.run_count++;
+    stats.run_time_total_us += run_time_us;
+    stats.run_time_max_us = MAX(stats.run_time_max_us, run_time_us);
+    stats.late_ms_max = MAX(stats.late_ms_max, (uint16_t)MIN(late_ms, (uint32_t)UINT16_MAX));
+    uint8_t bin = 0;
+    for (uint32_t limit_ms = 1; bin < LATENCY_BINS-1 && late_ms >= limit_ms; limit_ms *= 10) {
+        bin++;
+    }
+    if (stats.late_hist[bin] < UINT16_MAX) {
+        stats.late_hist[bin]++;
+    }
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - stats.last_log_ms < SCRIPT_STATS_LOG_INTERVAL_MS) {
+        return;
+    }
+    stats.last_log_ms = now_ms;
+
+    if (option_is_set(AP_Scripting::DebugOption::RUNTIME_MSG)) {
+        GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: %s runs:%u avg:%uus max:%uus late max:%ums",
+                      script->name,
+                      (unsigned)stats.run_count,
+                      (unsigned)(stats.run_time_total_us / stats.run_count),
+                      (unsigned)stats.run_time_max_us,
+                      (unsigned)stats.late_ms_max);
+    }
+#if HAL_LOGGING_ENABLED
+    if (option_is_set(AP_Scripting::DebugOption::LOG_RUNTIME)) {
+        char name[16] {};
+        const char *name_short = strrchr(script->name, '/');
+        strncpy_noterm(name, name_short != nullptr ? name_short+1 : script->name, sizeof(name));
+// @LoggerMessage: SCRS
+// @Description: Per-script run statistics since the previous SCRS message for the same script
+// @Field: TimeUS: Time since system startup
+// @Field: Name: script name
+// @Field: N: number of runs
+// @Field: TAvg: average run time
+// @Field: TMax: maximum run time
+// @Field: LMax: maximum lateness against the requested run time
+// @Field: L1: runs started less than 1ms late
+// @Field: L10: runs started 1ms to 10ms late
+// @Field: L100: runs started 10ms to 100ms late
+// @Field: LBig: runs started 100ms or more late
+        AP::logger().Write("SCRS", "TimeUS,Name,N,TAvg,TMax,LMax,L1,L10,L100,LBig",
+                           "s#-sss----", "F--FFC----", "QNIIIHHHHH",
+                           AP_HAL::micros64(),
+                           name,
+                           stats.run_count,
+                           stats.run_time_total_us / stats.run_count,
+                           stats.run_time_max_us,
+                           stats.late_ms_max,
+                           stats.late_hist[0],
+                           stats.late_hist[1],
+                           stats.late_hist[2],
+                           stats.late_hist[3]);
+    }
+#endif // HAL_LOGGING_ENABLED
+
+    // start a new period, keeping the log time
+    const uint32_t last_log_ms = stats.last_log_ms;
+    stats = {};
+    stats.last_log_ms = last_log_ms;
+}
+
 bool lua_scripts::load_script(lua_State *L, script_info *new_script) {
     const char *filename = new_script->name;
 
-    if (int error = luaL_loadfile(L, filename)) {
+    uint32_t crc = 0;
+    if (int error = load_script_file(L, filename, crc)) {
         switch (error) {
             case LUA_ERRSYNTAX:
                 set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "Error: %s", get_error_object_message(L));
@@ -199,17 +341,13 @@ bool lua_scripts::load_script(lua_State *L, script_info *new_script) {
     new_script->run_ref = luaL_ref(L, LUA_REGISTRYINDEX); // store reference to function to run
     new_script->next_run_ms = AP_HAL::millis64() - 1; // force the script to be stale
 
-    // Get checksum of file
-    uint32_t crc = 0;
-    if (AP::FS().crc32(filename, crc)) {
-        // Record crc of this script
-        new_script->crc = crc;
-        {
-            // Apply crc to checksum of all scripts
-            WITH_SEMAPHORE(crc_sem);
-            loaded_checksum ^= crc;
-            running_checksum ^= crc;
-        }
+    // Record crc of this script, computed while loading
+    new_script->crc = crc;
+    {
+        // Apply crc to checksum of all scripts
+        WITH_SEMAPHORE(crc_sem);
+        loaded_checksum ^= crc;
+        running_checksum ^= crc;
     }
 
     return true;
@@ -287,6 +425,8 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         script->env_ref = LUA_NOREF;
         script->run_ref = LUA_NOREF;
         script->crc = 0; // ensure removing it has no effect on the CRC
+        script->stats = {};
+        script->stats.last_log_ms = AP_HAL::millis();
         script->name = filename;
         script->next = scripts;
         scripts = script;
@@ -315,7 +455,8 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
 
 void lua_scripts::reset_loop_overtime(lua_State *L) {
     overtime = false;
-    // reset the hook to clear the counter
+    // reset the hook to clear the counter, this is done before each
+    // script is run so every run of every script gets the full budget
     const int32_t vm_steps = MAX(_vm_steps, 1000);
     lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
 }
@@ -329,10 +470,13 @@ void lua_scripts::run_next_script(lua_State *L) {
     }
 
     uint64_t start_time_ms = AP_HAL::millis64();
+    const uint32_t start_time_us = AP_HAL::micros();
     // strip the selected script out of the list
     script_info *script = scripts;
     scripts = script->next;
 
+    const uint32_t late_ms = start_time_ms > script->next_run_ms ? (uint32_t)MIN(start_time_ms - script->next_run_ms, (uint64_t)UINT32_MAX) : 0;
+
     // reset the hook to clear the counter
     reset_loop_overtime(L);
 
@@ -377,6 +521,8 @@ void lua_scripts::run_next_script(lua_State *L) {
                         return;
                     }
 
+                    update_script_stats(script, AP_HAL::micros() - start_time_us, late_ms);
+
                     // types match the expectations, go ahead and reschedule
                     script->next_run_ms = start_time_ms + (uint64_t)luaL_checknumber(L, -1);
                     lua_pop(L, 1);
@@ -65,12 +65,24 @@ private:
 
     void create_sandbox(lua_State *L);
 
+    // per-script run statistics, lateness is bucketed at <1ms, <10ms, <100ms and >=100ms
+    static const uint8_t LATENCY_BINS = 4;
+    struct script_stats {
+       uint32_t run_count;
+       uint32_t run_time_total_us;
+       uint32_t run_time_max_us;
+       uint16_t late_ms_max;
+       uint16_t late_hist[LATENCY_BINS];
+       uint32_t last_log_ms;
+    };
+
     typedef struct script_info {
        int env_ref;          // reference to the script's environment table
        int run_ref;          // reference to the function to run
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
        uint32_t crc;         // crc32 checksum
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       script_stats stats;
        script_info *next;
     } script_info;
 
@@ -107,6 +119,9 @@ private:
     // helper for print and log of runtime stats
     void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem);
 
+    // accumulate per-script statistics, logging them every SCRIPT_STATS_LOG_INTERVAL_MS
+    void update_script_stats(script_info *script, uint32_t run_time_us, uint32_t late_ms);
+
     // must be static for bindings
     static void print_error(MAV_SEVERITY severity);
     static char *error_msg_buf;
@@ -30,8 +30,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.  Boards with less than 1MB of RAM are limited to 500 points.
+    // @Range: 0 3000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -67,6 +67,15 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 *    2. Simplification uses the Ramer-Douglas-Peucker algorithm. See Wikipedia
 *    for a more complete description.
 *
+*    To avoid comparing every segment against every other segment, pruning
+*    first registers each segment in every cell of a horizontal grid that it
+*    passes through.  Only segments registered in the cells around a given
+*    segment need to be compared with it, so the cost of detection depends on
+*    how crowded the path is rather than how long it is.  The grid is aligned
+*    with the direction most of the path was flown in and its cells are at
+*    least twice SMARTRTL_PRUNING_DELTA wide.  Cells are made larger for long
+*    paths so that the grid fits in a fixed number of entries.
+*
 *    The simplification and pruning algorithms run in the background and do not
 *    alter the path in memory.  Two definitions, SMARTRTL_SIMPLIFY_TIME_US and
 *    SMARTRTL_PRUNING_LOOP_TIME_US are used to limit how long each algorithm will
@@ -118,19 +127,35 @@ void AP_SmartRTL::init()
     _prune.loops_max = _points_max * SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT;
     _prune.loops = (prune_loop_t*)calloc(_prune.loops_max, sizeof(prune_loop_t));
 
+    _prune.grid_buckets = 16;
+    while (_prune.grid_buckets < _points_max / 2) {
+        _prune.grid_buckets *= 2;
+    }
+    _prune.grid_head = (uint16_t*)calloc(_prune.grid_buckets, sizeof(uint16_t));
+    _prune.grid_entries_max = _points_max * SMARTRTL_PRUNING_GRID_ENTRIES_MULT;
+    _prune.grid_entries = (prune_grid_entry_t*)calloc(_prune.grid_entries_max, sizeof(prune_grid_entry_t));
+
     _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
     _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
 
     // check if memory allocation failed
-    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
+    if (_path == nullptr || _prune.loops == nullptr || _prune.grid_head == nullptr || _prune.grid_entries == nullptr || _simplify.stack == nullptr) {
         log_action(Action::DEACTIVATED_INIT_FAILED);
         GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "SmartRTL deactivated: init failed");
         free(_path);
         free(_prune.loops);
+        free(_prune.grid_head);
+        free(_prune.grid_entries);
         free(_simplify.stack);
         return;
     }
 
+    _stats.mem_bytes = _points_max * sizeof(Vector3f) +
+                       _prune.grid_buckets * sizeof(uint16_t) +
+                       _prune.grid_entries_max * sizeof(prune_grid_entry_t) +
+                       _prune.loops_max * sizeof(prune_loop_t) +
+                       _simplify.stack_max * sizeof(simplify_start_finish_t);
+
     _path_points_max = _points_max;
 
     // when running the example sketch, we want the cleanup tasks to run when we tell them to, not in the background (so that they can be timed.)
@@ -373,6 +398,8 @@ void AP_SmartRTL::run_background_cleanup()
     _path_points_completed_limit = SMARTRTL_POINTS_MAX;
     _path_sem.give();
 
+    const uint32_t start_us = AP_HAL::micros();
+
     // check if thorough cleanup is required
     if (_thorough_clean_request_ms > 0) {
         // check if we have already completed the request
@@ -382,19 +409,34 @@ void AP_SmartRTL::run_background_cleanup()
                 _thorough_clean_complete_ms = _thorough_clean_request_ms;
             }
         }
-        // we do not perform any further detection or cleanup until the requester acknowledges
-        // they have what they need by setting _thorough_clean_request_ms back to zero
-        return;
+    } else {
+        // ensure clean complete time is zero
+        _thorough_clean_complete_ms = 0;
+
+        // perform routine cleanup which removes 10 to 50 points if possible
+        routine_cleanup(path_points_count, path_points_completed_limit);
     }
 
-    // ensure clean complete time is zero
-    _thorough_clean_complete_ms = 0;
+    // accumulate time statistics
+    const uint32_t dt_us = AP_HAL::micros() - start_us;
+    _stats.cleanup_us += dt_us;
+    _stats.cleanup_max_us = MAX(_stats.cleanup_max_us, dt_us);
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _stats.last_log_ms >= SMARTRTL_STATS_LOG_INTERVAL_MS) {
+        _stats.last_log_ms = now_ms;
+        log_stats();
+        _stats.cleanup_us = 0;
+        _stats.cleanup_max_us = 0;
+    }
 
-    // perform routine cleanup which removes 10 to 50 points if possible
-    routine_cleanup(path_points_count, path_points_completed_limit);
+    // we do not perform any further detection or cleanup until the requester acknowledges
+    // they have what they need by setting _thorough_clean_request_ms back to zero
+    if (_thorough_clean_request_ms > 0) {
+        return;
+    }
 
     // warn if buffer is about to be filled
-    uint32_t now_ms = AP_HAL::millis();
     if ((path_points_count >0) && (path_points_count >= _path_points_max - 9) && (now_ms - _last_low_space_notify_ms > 10000)) {
         GCS_SEND_TEXT(MAV_SEVERITY_INFO, "SmartRTL Low on space!");
        _last_low_space_notify_ms = now_ms;
@@ -567,7 +609,11 @@ void AP_SmartRTL::detect_simplifications()
 /**
 *   This method runs for the allotted time, and detects loops in a path. Any detected loops are added to _prune.loops,
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
-*   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
+*   to the line segments between other sequential points which pass through the same or neighbouring cells of a grid.
+*   If they get close enough, anything between them could be pruned.
+*
+*   The grid is built one segment at a time and the cells around each segment are searched a few entries at a time,
+*   so this method can always return after SMARTRTL_PRUNING_LOOP_TIME_US.
 *
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
@@ -585,33 +631,274 @@ void AP_SmartRTL::detect_loops()
     // run for defined amount of time
     while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
 
-        // advance inner loop
-        _prune.j++;
-        if (_prune.j > _prune.i - 2) {
-            // set inner loop back to first point
-            _prune.j = 1;
-            // reduce outer loop
-            _prune.i--;
-            // complete when outer loop has run out of new points to check
-            if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+        // build the grid of segments before searching it
+        if (_prune.grid_state != PruneGridState::READY) {
+            grid_build_step();
+            continue;
+        }
+
+        // search the next cell around the segment ending at point i
+        if (!search_loop_step(_prune.i)) {
+            continue;
+        }
+
+        // if there is a loop here, add to loop array
+        if (_prune.search.found) {
+            if (!add_loop(_prune.search.j, _prune.i-1, _prune.search.midpoint)) {
+                // if the buffer is full, stop trying to prune
                 _prune.complete = true;
-                _prune.path_points_completed = _prune.path_points_count;
                 return;
             }
         }
 
-        // find the closest distance between two line segments and the mid-point
-        dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
-        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
-            // if there is a loop here, add to loop array
-            if (!add_loop(_prune.j, _prune.i-1, dp.midpoint)) {
-                // if the buffer is full, stop trying to prune
-                _prune.complete = true;
+        // move to the next segment
+        _prune.i--;
+        reset_loop_search();
+
+        // complete when outer loop has run out of new points to check
+        if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+            _prune.complete = true;
+            _prune.path_points_completed = _prune.path_points_count;
+            return;
+        }
+    }
+}
+
+// rotate the horizontal part of a vector into the grid's axes
+Vector2f AP_SmartRTL::grid_rotate(const Vector3f &v) const
+{
+    return Vector2f(v.x * _prune.grid_axis.x + v.y * _prune.grid_axis.y,
+                    -v.x * _prune.grid_axis.y + v.y * _prune.grid_axis.x);
+}
+
+// get the grid cell containing a point
+void AP_SmartRTL::grid_cell(const Vector3f &point, int32_t &cx, int32_t &cy) const
+{
+    const Vector2f uv = grid_rotate(point);
+    cx = (int32_t)floorf(uv.x / _prune.grid_cell_size.x);
+    cy = (int32_t)floorf(uv.y / _prune.grid_cell_size.y);
+}
+
+// get the bucket holding the segments registered in a grid cell.  Several cells share each bucket
+uint16_t AP_SmartRTL::grid_bucket(int32_t cx, int32_t cy) const
+{
+    return (((uint32_t)cx * 73856093U) ^ ((uint32_t)cy * 19349663U)) & (_prune.grid_buckets - 1);
+}
+
+// number of points at which a segment from p1 to p2 is sampled to find the cells it passes through
+// samples are no more than half a cell apart along each axis so every cell the segment passes through is next to a sampled cell
+uint16_t AP_SmartRTL::grid_num_samples(const Vector3f &p1, const Vector3f &p2) const
+{
+    const Vector2f uv = grid_rotate(p2 - p1);
+    const float samples = MAX(fabsf(uv.x) / (0.5f * _prune.grid_cell_size.x), fabsf(uv.y) / (0.5f * _prune.grid_cell_size.y));
+    return (uint16_t)MIN(ceilf(samples), UINT16_MAX - 1) + 1;
+}
+
+// get the cell of the k'th of num_samples points along the segment from p1 to p2
+void AP_SmartRTL::grid_sample_cell(const Vector3f &p1, const Vector3f &p2, uint16_t k, uint16_t num_samples, int32_t &cx, int32_t &cy) const
+{
+    if (num_samples <= 1) {
+        grid_cell(p1, cx, cy);
+        return;
+    }
+    grid_cell(p1 + (p2 - p1) * ((float)k / (num_samples - 1)), cx, cy);
+}
+
+// clear all segments from the grid
+void AP_SmartRTL::grid_clear()
+{
+    memset(_prune.grid_head, 0xFF, _prune.grid_buckets * sizeof(uint16_t));
+    _prune.grid_entries_count = 0;
+}
+
+// register the segment ending at point seg in every grid cell it passes through
+// returns false if there are not enough grid entries
+bool AP_SmartRTL::grid_insert(uint16_t seg)
+{
+    const Vector3f &p1 = _path[seg-1];
+    const Vector3f &p2 = _path[seg];
+    const uint16_t num_samples = grid_num_samples(p1, p2);
+    int32_t last_cx = 0, last_cy = 0;
+    for (uint16_t k = 0; k < num_samples; k++) {
+        int32_t cx, cy;
+        grid_sample_cell(p1, p2, k, num_samples, cx, cy);
+        if (k > 0 && cx == last_cx && cy == last_cy) {
+            continue;
+        }
+        last_cx = cx;
+        last_cy = cy;
+        if (_prune.grid_entries_count >= _prune.grid_entries_max) {
+            return false;
+        }
+        const uint16_t bucket = grid_bucket(cx, cy);
+        prune_grid_entry_t &entry = _prune.grid_entries[_prune.grid_entries_count];
+        entry.segment = seg;
+        entry.next = _prune.grid_head[bucket];
+        _prune.grid_head[bucket] = _prune.grid_entries_count++;
+    }
+    return true;
+}
+
+// build the grid of the path's segments one segment at a time
+void AP_SmartRTL::grid_build_step()
+{
+    const uint16_t num_segments = MIN(_prune.path_points_count, _path_points_max) - 1;
+
+    switch (_prune.grid_state) {
+    case PruneGridState::MEASURE_DIRECTION:
+        // sum the segments with their heading doubled so that segments flown in opposite directions add together
+        if (_prune.grid_k <= num_segments) {
+            const Vector3f &p1 = _path[_prune.grid_k-1];
+            const Vector3f &p2 = _path[_prune.grid_k];
+            const float dx = p2.x - p1.x;
+            const float dy = p2.y - p1.y;
+            const float length = norm(dx, dy);
+            if (is_positive(length)) {
+                _prune.grid_axis += Vector2f(dx * dx - dy * dy, 2.0f * dx * dy) / length;
+            }
+            _prune.grid_k++;
+            return;
+        }
+        // align the grid with the direction most of the path was flown in, so that long parallel
+        // segments (e.g. survey legs) each stay within a single row of cells
+        if (_prune.grid_axis.is_zero()) {
+            _prune.grid_axis = Vector2f(1.0f, 0.0f);
+        } else {
+            const float angle = 0.5f * atan2f(_prune.grid_axis.y, _prune.grid_axis.x);
+            _prune.grid_axis = Vector2f(cosf(angle), sinf(angle));
+        }
+        _prune.grid_k = 1;
+        _prune.grid_state = PruneGridState::MEASURE_LENGTH;
+        return;
+
+    case PruneGridState::MEASURE_LENGTH: {
+        // sum the length of the path along each of the grid's axes to choose the cell size
+        if (_prune.grid_k <= num_segments) {
+            const Vector2f uv = grid_rotate(_path[_prune.grid_k] - _path[_prune.grid_k-1]);
+            _prune.grid_cell_size.x += fabsf(uv.x);
+            _prune.grid_cell_size.y += fabsf(uv.y);
+            _prune.grid_k++;
+            return;
+        }
+        // cells must be at least twice the pruning distance wide so segments which come close
+        // are always registered in neighbouring cells.  Long paths use larger cells so that
+        // each segment is registered in about two cells on average
+        const float spare_entries = MAX(_prune.grid_entries_max - num_segments, 2);
+        const float cell_size_min = MAX(2.0f * SMARTRTL_PRUNING_DELTA, 0.1f);
+        _prune.grid_cell_size.x = MAX(cell_size_min, 4.0f * _prune.grid_cell_size.x / spare_entries);
+        _prune.grid_cell_size.y = MAX(cell_size_min, 4.0f * _prune.grid_cell_size.y / spare_entries);
+        grid_clear();
+        _prune.grid_k = 1;
+        _prune.grid_state = PruneGridState::INSERT;
+        return;
+    }
+
+    case PruneGridState::INSERT:
+        if (_prune.grid_k > num_segments) {
+            _prune.grid_state = PruneGridState::READY;
+            return;
+        }
+        if (!grid_insert(_prune.grid_k)) {
+            // out of entries, start again with larger cells
+            _prune.grid_cell_size *= 2.0f;
+            grid_clear();
+            _prune.grid_k = 1;
+            return;
+        }
+        _prune.grid_k++;
+        return;
+
+    case PruneGridState::READY:
+        return;
+    }
+}
+
+// start building the grid again because points have been added to or removed from the path
+void AP_SmartRTL::grid_restart()
+{
+    _prune.grid_state = PruneGridState::MEASURE_DIRECTION;
+    _prune.grid_k = 1;
+    _prune.grid_axis.zero();
+    _prune.grid_cell_size.zero();
+    reset_loop_search();
+}
+
+// forget any progress searching for a loop for the segment ending at point i
+void AP_SmartRTL::reset_loop_search()
+{
+    _prune.search.sample = 0;
+    _prune.search.neighbour = 0;
+    _prune.search.entry = SMARTRTL_PRUNING_GRID_NONE;
+    _prune.search.found = false;
+}
+
+// search part of the grid around the segment ending at point i for the earliest segment which comes within
+// SMARTRTL_PRUNING_DELTA.  Only segments ending at or before point i-2 are considered (consecutive segments always touch)
+// returns true once all the cells have been searched, with the result in _prune.search
+bool AP_SmartRTL::search_loop_step(uint16_t i)
+{
+    const Vector3f &p1 = _path[i];
+    const Vector3f &p2 = _path[i-1];
+
+    if (_prune.search.entry == SMARTRTL_PRUNING_GRID_NONE) {
+        // move to the cell of the next sample, skipping samples in the same cell as the last
+        if (_prune.search.neighbour == 0) {
+            const uint16_t num_samples = grid_num_samples(p1, p2);
+            while (true) {
+                if (_prune.search.sample >= num_samples) {
+                    return true;
+                }
+                int32_t cx, cy;
+                grid_sample_cell(p1, p2, _prune.search.sample, num_samples, cx, cy);
+                const bool first = (_prune.search.sample == 0);
+                _prune.search.sample++;
+                if (first || cx != _prune.search.cx || cy != _prune.search.cy) {
+                    _prune.search.cx = cx;
+                    _prune.search.cy = cy;
+                    break;
+                }
             }
-            // set inner loop forward to trigger outer loop move to next segment
-            _prune.j = _prune.i;
         }
+
+        // start on the segments registered in this cell or its next neighbour
+        const int32_t cx = _prune.search.cx + (_prune.search.neighbour % 3) - 1;
+        const int32_t cy = _prune.search.cy + (_prune.search.neighbour / 3) - 1;
+        _prune.search.neighbour = (_prune.search.neighbour + 1) % 9;
+        _prune.search.entry = _prune.grid_head[grid_bucket(cx, cy)];
     }
+
+    const float delta = SMARTRTL_PRUNING_DELTA;
+    const float x_min = MIN(p1.x, p2.x) - delta;
+    const float x_max = MAX(p1.x, p2.x) + delta;
+    const float y_min = MIN(p1.y, p2.y) - delta;
+    const float y_max = MAX(p1.y, p2.y) + delta;
+    const float z_min = MIN(p1.z, p2.z) - delta;
+    const float z_max = MAX(p1.z, p2.z) + delta;
+
+    // check a limited number of segments so a crowded cell cannot overrun SMARTRTL_PRUNING_LOOP_TIME_US
+    for (uint8_t checked = 0; checked < SMARTRTL_PRUNING_GRID_CHECKS_MAX && _prune.search.entry != SMARTRTL_PRUNING_GRID_NONE; checked++) {
+        const uint16_t seg = _prune.grid_entries[_prune.search.entry].segment;
+        _prune.search.entry = _prune.grid_entries[_prune.search.entry].next;
+        // skip consecutive segments and any later than the best found so far
+        if (seg + 2 > i || (_prune.search.found && seg >= _prune.search.j)) {
+            continue;
+        }
+        // reject segments whose bounding box is too far away
+        const Vector3f &p3 = _path[seg-1];
+        const Vector3f &p4 = _path[seg];
+        if (MAX(p3.x, p4.x) < x_min || MIN(p3.x, p4.x) > x_max ||
+            MAX(p3.y, p4.y) < y_min || MIN(p3.y, p4.y) > y_max ||
+            MAX(p3.z, p4.z) < z_min || MIN(p3.z, p4.z) > z_max) {
+            continue;
+        }
+        const dist_point dp = segment_segment_dist(p1, p2, p3, p4);
+        if (dp.distance < delta) {
+            _prune.search.found = true;
+            _prune.search.j = seg;
+            _prune.search.midpoint = dp.midpoint;
+        }
+    }
+    return false;
 }
 
 // restart simplify if new points have been added to path
@@ -655,8 +942,8 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
 {
     _prune.complete = false;
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
-    _prune.j = 0;
     _prune.path_points_count = path_points_count;
+    grid_restart();
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
@@ -698,6 +985,9 @@ void AP_SmartRTL::remove_points_by_simplify_bitmask()
 
     _path_sem.give();
 
+    // segment indexes have changed
+    grid_restart();
+
     // flag point removal is complete
     _simplify.bitmask.setall();
     _simplify.removal_required = false;
@@ -760,6 +1050,9 @@ bool AP_SmartRTL::remove_points_by_loops(uint16_t num_points_to_remove)
         _prune.loops_count--;
     }
 
+    // segment indexes have changed
+    grid_restart();
+
     _path_sem.give();
     return true;
 }
@@ -883,6 +1176,35 @@ void AP_SmartRTL::log_action(Action action, const Vector3f &point) const
         AP::logger().Write_SRTL(_active, _path_points_count, _path_points_max, action, point);
     }
 }
+
+// log memory use and time spent in background cleanup
+void AP_SmartRTL::log_stats()
+{
+    if (_example_mode) {
+        return;
+    }
+    // @LoggerMessage: SRTS
+    // @Description: SmartRTL memory and cleanup statistics
+    // @Field: TimeUS: Time since system startup
+    // @Field: NumPts: number of points currently in use
+    // @Field: MaxPts: maximum number of points that could be used
+    // @Field: Loops: number of loops found by pruning and not yet removed
+    // @Field: Mem: memory allocated for the path and cleanup algorithms
+    // @Field: CTot: total time spent in background cleanup since last message
+    // @Field: CMax: longest single background cleanup run since last message
+    AP::logger().Write("SRTS",
+                       "TimeUS,NumPts,MaxPts,Loops,Mem,CTot,CMax",
+                       "s---bss",
+                       "F----FF",
+                       "QHHHIII",
+                       AP_HAL::micros64(),
+                       _path_points_count,
+                       _path_points_max,
+                       _prune.loops_count,
+                       _stats.mem_bytes,
+                       _stats.cleanup_us,
+                       _stats.cleanup_max_us);
+}
 #endif
 
 // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
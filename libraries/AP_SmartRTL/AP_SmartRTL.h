@@ -8,7 +8,13 @@
 // definitions and macros
 #define SMARTRTL_ACCURACY_DEFAULT        2.0f   // default _ACCURACY parameter value.  Points will be no closer than this distance (in meters) together.
 #define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 20bytes * this number.
+#ifndef SMARTRTL_POINTS_MAX
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_1000
+#define SMARTRTL_POINTS_MAX              3000   // the absolute maximum number of points this library can support.
+#else
 #define SMARTRTL_POINTS_MAX              500    // the absolute maximum number of points this library can support.
+#endif
+#endif
 #define SMARTRTL_TIMEOUT                 15000  // the time in milliseconds with no points saved to the path (for whatever reason), before SmartRTL is disabled for the flight
 #define SMARTRTL_CLEANUP_POINT_TRIGGER   50     // simplification will trigger when this many points are added to the path
 #define SMARTRTL_CLEANUP_START_MARGIN    10     // routine cleanup algorithms begin when the path array has only this many empty slots remaining
@@ -21,6 +27,10 @@
 #define SMARTRTL_PRUNING_DELTA (_accuracy * 0.99)   // How many meters apart must two points be, such that we can assume that there is no obstacle between them.  must be smaller than _ACCURACY parameter
 #define SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT 0.25f // pruning loop buffer size as compared to maximum number of points
 #define SMARTRTL_PRUNING_LOOP_TIME_US    200    // maximum time (in microseconds) that the loop finding algorithm will run before returning
+#define SMARTRTL_PRUNING_GRID_ENTRIES_MULT 2    // pruning grid entries as compared to maximum number of points
+#define SMARTRTL_PRUNING_GRID_NONE       0xFFFF // marks the end of a list of pruning grid entries
+#define SMARTRTL_PRUNING_GRID_CHECKS_MAX 16     // maximum number of pruning grid entries checked before the loop finding algorithm checks the time
+#define SMARTRTL_STATS_LOG_INTERVAL_MS   10000  // interval (in milliseconds) at which memory and cleanup time statistics are logged
 
 class AP_SmartRTL {
 
@@ -158,6 +168,22 @@ private:
     // returns false if it failed to remove points (because it could not take semaphore)
     bool remove_points_by_loops(uint16_t num_points_to_remove);
 
+    // grid of the segments of the path being pruned, used to find segments which may be close to each other
+    Vector2f grid_rotate(const Vector3f &v) const;
+    void grid_cell(const Vector3f &point, int32_t &cx, int32_t &cy) const;
+    uint16_t grid_bucket(int32_t cx, int32_t cy) const;
+    uint16_t grid_num_samples(const Vector3f &p1, const Vector3f &p2) const;
+    void grid_sample_cell(const Vector3f &p1, const Vector3f &p2, uint16_t k, uint16_t num_samples, int32_t &cx, int32_t &cy) const;
+    void grid_clear();
+    bool grid_insert(uint16_t seg);
+    void grid_build_step();
+    void grid_restart();
+
+    // search for the earliest segment which comes within SMARTRTL_PRUNING_DELTA of the segment between points i-1 and i
+    //  searches one grid cell per call, returns true once complete with the result in _prune.search
+    bool search_loop_step(uint16_t i);
+    void reset_loop_search();
+
     // add loop to loops array
     //  returns true if loop added successfully, false on failure (because loop array is full)
     //  checks if loop overlaps with an existing loop, keeps only the longer loop
@@ -179,8 +205,10 @@ private:
 #if HAL_LOGGING_ENABLED
     // logging
     void log_action(Action action, const Vector3f &point = Vector3f()) const;
+    void log_stats();
 #else
     void log_action(Action action, const Vector3f &point = Vector3f()) const {}
+    void log_stats() {}
 #endif
 
     // parameters
@@ -230,17 +258,52 @@ private:
         Vector3f midpoint;      // midpoint which should replace the first point when the loop is removed
         float length_squared;   // length squared (in meters) of the loop (used so we can remove the longest loops)
     } prune_loop_t;
+    typedef struct {
+        uint16_t segment;       // index of the end point of the segment
+        uint16_t next;          // index of the next entry in the same bucket, SMARTRTL_PRUNING_GRID_NONE if last
+    } prune_grid_entry_t;
+    enum class PruneGridState : uint8_t {
+        MEASURE_DIRECTION,  // finding the direction most of the path was flown in
+        MEASURE_LENGTH,     // measuring the length of the path along the grid's axes
+        INSERT,             // adding segments to the grid
+        READY,              // grid holds all segments of the path
+    };
     struct {
         bool complete;
         uint16_t path_points_count;  // copy of _path_points_count taken when the prune algorithm started
         uint16_t path_points_completed; // number of points in that path that have already been checked for loops and should be ignored
-        uint16_t i;     // loop search's outer loop index
-        uint16_t j;     // loop search's inner loop index
+        uint16_t i;     // loop search's index of the end point of the segment being checked
         prune_loop_t* loops;// the result of the pruning algorithm
         uint16_t loops_max; // maximum number of elements in the _prunable_loops array
         uint16_t loops_count;   // number of elements in the _prunable_loops array
+        PruneGridState grid_state;  // progress building the grid for the current path_points_count
+        uint16_t grid_k;        // end point index of the next segment to be measured or added to the grid
+        Vector2f grid_axis;     // unit vector along the grid's x axis, in NE frame
+        Vector2f grid_cell_size;    // size (in meters) of each grid cell along the grid's axes
+        uint16_t* grid_head;    // index of the first entry in each bucket, SMARTRTL_PRUNING_GRID_NONE if empty
+        uint16_t grid_buckets;  // number of elements in the grid_head array, a power of two
+        prune_grid_entry_t* grid_entries;   // segments registered in each grid cell
+        uint16_t grid_entries_max;  // maximum number of elements in the grid_entries array
+        uint16_t grid_entries_count;    // number of elements in the grid_entries array
+        struct {
+            uint16_t sample;    // next sample along segment i whose cell should be searched
+            uint8_t neighbour;  // next of the 9 cells around the current sample's cell to search
+            uint16_t entry;     // next grid entry to check in the current cell, SMARTRTL_PRUNING_GRID_NONE if finished
+            int32_t cx, cy;     // cell of the current sample
+            bool found;         // true if a segment close to segment i has been found
+            uint16_t j;         // end point index of the earliest close segment found
+            Vector3f midpoint;  // point between the closest points of segment i and segment j
+        } search;
     } _prune;
 
+    // memory and time statistics, logged every SMARTRTL_STATS_LOG_INTERVAL_MS
+    struct {
+        uint32_t mem_bytes;     // memory allocated for the path and cleanup algorithms
+        uint32_t cleanup_us;    // time spent in background cleanup since last logged
+        uint32_t cleanup_max_us;// longest single background cleanup call since last logged
+        uint32_t last_log_ms;   // system time statistics were last logged
+    } _stats;
+
     // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
     bool loops_overlap(const prune_loop_t& loop1, const prune_loop_t& loop2) const;
 };
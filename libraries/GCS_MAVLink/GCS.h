@@ -1304,6 +1304,54 @@ public:
     uint8_t get_available_modes_sequence() const { return available_modes_sequence; }
     void available_modes_changed() { available_modes_sequence += 1; }
 
+    /*
+      cache of a message payload whose content does not depend on the
+      link it is sent on.  The first link to send the message in a
+      GCS::update_send() call generates the payload and stores it
+      here; later links in the same call reuse it and only frame (and
+      sign) it for their own channel.
+     */
+    class PayloadCacheEntry {
+    public:
+        // returns true if the entry was stored during the current
+        // GCS::update_send() call
+        bool is_current() const;
+    protected:
+        void mark_current();
+    private:
+        uint32_t send_cycle;
+    };
+    template <typename T>
+    class PayloadCache : public PayloadCacheEntry {
+    public:
+        // fill in pkt from the cache, returns false if the cached
+        // payload is stale and must be regenerated
+        bool get(T &pkt) const {
+            if (!is_current()) {
+                return false;
+            }
+            pkt = _pkt;
+            return true;
+        }
+        void set(const T &pkt) {
+            _pkt = pkt;
+            mark_current();
+        }
+    private:
+        T _pkt;
+    };
+
+    struct {
+#if AP_AHRS_ENABLED
+        PayloadCache<mavlink_attitude_t> attitude;
+        PayloadCache<mavlink_global_position_int_t> global_position_int;
+#endif
+        PayloadCache<mavlink_sys_status_t> sys_status;
+    } payload_cache;
+
+    // counts calls to update_send(); zero while not inside update_send()
+    uint32_t current_send_cycle() const { return _send_cycle; }
+
 protected:
 
     virtual GCS_MAVLINK *new_gcs_mavlink_backend(AP_HAL::UARTDriver &uart) = 0;
@@ -1398,6 +1446,11 @@ private:
     // Sequence number should be incremented when available modes changes
     // Sent in AVAILABLE_MODES_MONITOR msg
     uint8_t available_modes_sequence;
+
+    // non-zero while update_send() is running, used to determine
+    // whether entries in payload_cache are current
+    uint32_t _send_cycle;
+    uint32_t _send_cycle_count;
 };
 
 GCS &gcs();
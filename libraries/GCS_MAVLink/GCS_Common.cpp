@@ -2770,6 +2770,14 @@ void GCS::update_send()
         prot->update();
     }
 
+    // start a new payload cache cycle; zero is reserved for "not
+    // inside update_send"
+    _send_cycle_count++;
+    if (_send_cycle_count == 0) {
+        _send_cycle_count = 1;
+    }
+    _send_cycle = _send_cycle_count;
+
     // round-robin the GCS_MAVLINK backend that gets to go first so
     // one backend doesn't monopolise all of the time allowed for sending
     // messages
@@ -2780,6 +2788,9 @@ void GCS::update_send()
         chan(i)->update_send();
     }
 
+    // messages sent outside update_send must not use cached payloads
+    _send_cycle = 0;
+
     service_statustext();
 
     first_backend_to_send++;
@@ -2788,6 +2799,21 @@ void GCS::update_send()
     }
 }
 
+bool GCS::PayloadCacheEntry::is_current() const
+{
+#if AP_MAVLINK_MSG_PAYLOAD_CACHE_ENABLED
+    const uint32_t cycle = gcs().current_send_cycle();
+    return cycle != 0 && send_cycle == cycle;
+#else
+    return false;
+#endif
+}
+
+void GCS::PayloadCacheEntry::mark_current()
+{
+    send_cycle = gcs().current_send_cycle();
+}
+
 void GCS::update_receive(void)
 {
     for (uint8_t i=0; i<num_gcs(); i++) {
@@ -5988,65 +6014,55 @@ void GCS_MAVLINK::send_sys_status()
     if (!gcs().vehicle_initialised()) {
         return;
     }
-#if AP_BATTERY_ENABLED
-    const AP_BattMonitor &battery = AP::battery();
-    float battery_current;
-    const int8_t battery_remaining = battery_remaining_pct(AP_BATT_PRIMARY_INSTANCE);
 
-    if (battery.healthy() && battery.current_amps(battery_current)) {
-        battery_current = constrain_float(battery_current * 100,-INT16_MAX,INT16_MAX);
-    } else {
-        battery_current = -1;
-    }
+    mavlink_sys_status_t pkt {};
+    if (!gcs().payload_cache.sys_status.get(pkt)) {
+#if AP_BATTERY_ENABLED
+        const AP_BattMonitor &battery = AP::battery();
+        float battery_current;
+        if (battery.healthy() && battery.current_amps(battery_current)) {
+            battery_current = constrain_float(battery_current * 100,-INT16_MAX,INT16_MAX);
+        } else {
+            battery_current = -1;
+        }
+        pkt.voltage_battery = battery.gcs_voltage() * 1000;  // mV
+        pkt.current_battery = battery_current;  // in 10mA units
+        pkt.battery_remaining = battery_remaining_pct(AP_BATT_PRIMARY_INSTANCE);  // in %
+#else
+        pkt.current_battery = -1;
+        pkt.battery_remaining = -1;
 #endif
 
-    uint32_t control_sensors_present;
-    uint32_t control_sensors_enabled;
-    uint32_t control_sensors_health;
+        gcs().get_sensor_status_flags(pkt.onboard_control_sensors_present,
+                                      pkt.onboard_control_sensors_enabled,
+                                      pkt.onboard_control_sensors_health);
 
-    gcs().get_sensor_status_flags(control_sensors_present, control_sensors_enabled, control_sensors_health);
-
-    const uint32_t errors = AP::internalerror().errors();
-    const uint16_t errors1 = errors & 0xffff;
-    const uint16_t errors2 = (errors>>16) & 0xffff;
-    const uint16_t errors4 = AP::internalerror().count() & 0xffff;
-    uint16_t errors_comm = 0;
-    mavlink_status_t *ms = mavlink_get_channel_status(chan);
-    if (ms) {
-        errors_comm = ms->packet_rx_drop_count;
-    }
+#if AP_SCHEDULER_ENABLED
+        pkt.load = static_cast<uint16_t>(AP::scheduler().load_average() * 1000);
+#endif
 
+        const uint32_t errors = AP::internalerror().errors();
+        pkt.errors_count1 = errors & 0xffff;
+        pkt.errors_count2 = (errors>>16) & 0xffff;
 #if HAL_LOGGING_ENABLED
-    const uint16_t dropped_logmessage_count = AP::logger().num_dropped();
+        pkt.errors_count3 = AP::logger().num_dropped();
 #else
-    const uint16_t dropped_logmessage_count = UINT16_MAX;
+        pkt.errors_count3 = UINT16_MAX;
 #endif  // HAL_LOGGING_ENABLED
+        pkt.errors_count4 = AP::internalerror().count() & 0xffff;
 
-    mavlink_msg_sys_status_send(
-        chan,
-        control_sensors_present,
-        control_sensors_enabled,
-        control_sensors_health,
-#if AP_SCHEDULER_ENABLED
-        static_cast<uint16_t>(AP::scheduler().load_average() * 1000),
-#else
-        0,
-#endif
-#if AP_BATTERY_ENABLED
-        battery.gcs_voltage() * 1000,  // mV
-        battery_current,        // in 10mA units
-        battery_remaining,      // in %
-#else
-        0,
-        -1,
-        -1,
-#endif
-        0,  // comm drops %,
-        errors_comm,  // comm drops in pkts,
-        errors1,
-        errors2,
-        dropped_logmessage_count,  // errors3
-        errors4); // errors4
+        gcs().payload_cache.sys_status.set(pkt);
+    }
+
+    // comm drops are specific to this link
+    pkt.drop_rate_comm = 0;
+    pkt.errors_comm = 0;
+    const mavlink_status_t *ms = mavlink_get_channel_status(chan);
+    if (ms) {
+        pkt.errors_comm = ms->packet_rx_drop_count;
+    }
+
+    mavlink_msg_sys_status_send_struct(chan, &pkt);
 }
 
 void GCS_MAVLINK::send_extended_sys_state() const
@@ -6057,17 +6073,20 @@ void GCS_MAVLINK::send_extended_sys_state() const
 void GCS_MAVLINK::send_attitude() const
 {
 #if AP_AHRS_ENABLED
-    const AP_AHRS &ahrs = AP::ahrs();
-    const Vector3f omega = ahrs.get_gyro();
-    mavlink_msg_attitude_send(
-        chan,
-        AP_HAL::millis(),
-        ahrs.get_roll_rad(),
-        ahrs.get_pitch_rad(),
-        ahrs.get_yaw_rad(),
-        omega.x,
-        omega.y,
-        omega.z);
+    mavlink_attitude_t pkt;
+    if (!gcs().payload_cache.attitude.get(pkt)) {
+        const AP_AHRS &ahrs = AP::ahrs();
+        const Vector3f omega = ahrs.get_gyro();
+        pkt.time_boot_ms = AP_HAL::millis();
+        pkt.roll = ahrs.get_roll_rad();
+        pkt.pitch = ahrs.get_pitch_rad();
+        pkt.yaw = ahrs.get_yaw_rad();
+        pkt.rollspeed = omega.x;
+        pkt.pitchspeed = omega.y;
+        pkt.yawspeed = omega.z;
+        gcs().payload_cache.attitude.set(pkt);
+    }
+    mavlink_msg_attitude_send_struct(chan, &pkt);
 #endif
 }
 
@@ -6113,26 +6132,30 @@ int32_t GCS_MAVLINK::global_position_int_relative_alt() const {
 void GCS_MAVLINK::send_global_position_int()
 {
 #if AP_AHRS_ENABLED
-    AP_AHRS &ahrs = AP::ahrs();
+    mavlink_global_position_int_t pkt;
+    if (!gcs().payload_cache.global_position_int.get(pkt)) {
+        AP_AHRS &ahrs = AP::ahrs();
 
-    UNUSED_RESULT(ahrs.get_location(global_position_current_loc)); // return value ignored; we send stale data
+        UNUSED_RESULT(ahrs.get_location(global_position_current_loc)); // return value ignored; we send stale data
 
-    Vector3f vel;
-    if (!ahrs.get_velocity_NED(vel)) {
-        vel.zero();
+        Vector3f vel;
+        if (!ahrs.get_velocity_NED(vel)) {
+            vel.zero();
+        }
+
+        pkt.time_boot_ms = AP_HAL::millis();
+        pkt.lat = global_position_current_loc.lat;            // in 1E7 degrees
+        pkt.lon = global_position_current_loc.lng;            // in 1E7 degrees
+        pkt.alt = global_position_int_alt();                  // millimeters above ground/sea level
+        pkt.relative_alt = global_position_int_relative_alt(); // millimeters above home
+        pkt.vx = vel.x * 100;                                 // X speed cm/s (+ve North)
+        pkt.vy = vel.y * 100;                                 // Y speed cm/s (+ve East)
+        pkt.vz = vel.z * 100;                                 // Z speed cm/s (+ve Down)
+        pkt.hdg = ahrs.yaw_sensor;                            // compass heading in 1/100 degree
+        gcs().payload_cache.global_position_int.set(pkt);
     }
 
-    mavlink_msg_global_position_int_send(
-        chan,
-        AP_HAL::millis(),
-        global_position_current_loc.lat, // in 1E7 degrees
-        global_position_current_loc.lng, // in 1E7 degrees
-        global_position_int_alt(),       // millimeters above ground/sea level
-        global_position_int_relative_alt(), // millimeters above home
-        vel.x * 100,                     // X speed cm/s (+ve North)
-        vel.y * 100,                     // Y speed cm/s (+ve East)
-        vel.z * 100,                     // Z speed cm/s (+ve Down)
-        ahrs.yaw_sensor);                // compass heading in 1/100 degree
+    mavlink_msg_global_position_int_send_struct(chan, &pkt);
 #endif  // AP_AHRS_ENABLED
 }
 
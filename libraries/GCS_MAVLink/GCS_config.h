@@ -19,6 +19,12 @@
 #define AP_MAVLINK_SIGNING_ENABLED HAL_GCS_ENABLED
 #endif  // AP_MAVLINK_SIGNING_ENABLED
 
+// cache link-independent message payloads so a message due on several
+// links in the same GCS::update_send() call is only generated once
+#ifndef AP_MAVLINK_MSG_PAYLOAD_CACHE_ENABLED
+#define AP_MAVLINK_MSG_PAYLOAD_CACHE_ENABLED HAL_GCS_ENABLED
+#endif  // AP_MAVLINK_MSG_PAYLOAD_CACHE_ENABLED
+
 #ifndef HAL_HIGH_LATENCY2_ENABLED
 #define HAL_HIGH_LATENCY2_ENABLED 1
 #endif
@@ -94,6 +100,12 @@
 #define AP_MAVLINK_FTP_ENABLED HAL_GCS_ENABLED
 #endif
 
+// receive complete mission uploads into RAM and only write them to
+// storage once the whole mission has been received and validated
+#ifndef AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+#define AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED (AP_MISSION_ENABLED && (HAL_MEM_CLASS >= HAL_MEM_CLASS_500))
+#endif
+
 // GCS should be using MISSION_REQUEST_INT instead; this is a waste of
 // flash.  MISSION_REQUEST was deprecated in June 2020.  We started
 // sending warnings to the GCS in Sep 2022 if MISSION_REQUEST was used.
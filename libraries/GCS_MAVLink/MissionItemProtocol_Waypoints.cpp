@@ -23,6 +23,7 @@
 
 #include "MissionItemProtocol_Waypoints.h"
 
+#include <AP_InternalError/AP_InternalError.h>
 #include <AP_Logger/AP_Logger.h>
 #include <AP_Mission/AP_Mission.h>
 
@@ -30,6 +31,12 @@
 
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::append_item(const mavlink_mission_item_int_t &mission_item_int)
 {
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+    if (staging()) {
+        return stage_item(mission_item_int);
+    }
+#endif
+
     // sanity check for DO_JUMP command
     AP_Mission::Mission_Command cmd {};
 
@@ -57,6 +64,14 @@ bool MissionItemProtocol_Waypoints::clear_all_items()
 
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::complete(const GCS_MAVLINK &_link)
 {
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+    if (staging()) {
+        const MAV_MISSION_RESULT ret = commit_staged_items(_link);
+        if (ret != MAV_MISSION_ACCEPTED) {
+            return ret;
+        }
+    }
+#endif
     _link.send_text(MAV_SEVERITY_INFO, "Flight plan received");
 #if HAL_LOGGING_ENABLED
     AP::logger().Write_EntireMission();
@@ -92,6 +107,11 @@ MAV_MISSION_RESULT MissionItemProtocol_Waypoints::get_item(uint16_t seq, mavlink
 }
 
 uint16_t MissionItemProtocol_Waypoints::item_count() const {
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+    if (receiving && staging()) {
+        return _new_items_count;
+    }
+#endif
     return mission.num_commands();
 }
 
@@ -101,6 +121,12 @@ uint16_t MissionItemProtocol_Waypoints::max_items() const {
 
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::replace_item(const mavlink_mission_item_int_t &mission_item_int)
 {
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+    if (staging()) {
+        return stage_item(mission_item_int);
+    }
+#endif
+
     AP_Mission::Mission_Command cmd {};
 
     const MAV_MISSION_RESULT res = AP_Mission::mavlink_int_to_mission_cmd(mission_item_int, cmd);
@@ -127,8 +153,88 @@ void MissionItemProtocol_Waypoints::timeout()
 
 void MissionItemProtocol_Waypoints::truncate(const mavlink_mission_count_t &packet)
 {
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+    if (staging()) {
+        // the stored mission is truncated when the staged items are committed
+        return;
+    }
+#endif
     // new mission arriving, truncate mission to be the same length
     mission.truncate(packet.count);
 }
 
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::allocate_receive_resources(const uint16_t count)
+{
+    if (_new_items != nullptr) {
+        // this is an error - the base class should have called
+        // free_upload_resources first
+        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        return MAV_MISSION_ERROR;
+    }
+    if (count == 0) {
+        return MAV_MISSION_ACCEPTED;
+    }
+    _new_items = NEW_NOTHROW AP_Mission::Mission_Command[count];
+    // not having the memory to stage the upload isn't fatal; items
+    // are written straight to storage instead
+    _new_items_count = (_new_items != nullptr) ? count : 0;
+    return MAV_MISSION_ACCEPTED;
+}
+
+void MissionItemProtocol_Waypoints::free_upload_resources()
+{
+    delete[] _new_items;
+    _new_items = nullptr;
+    _new_items_count = 0;
+}
+
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::stage_item(const mavlink_mission_item_int_t &mission_item_int)
+{
+    if (mission_item_int.seq >= _new_items_count) {
+        return MAV_MISSION_INVALID_SEQUENCE;
+    }
+
+    AP_Mission::Mission_Command &cmd = _new_items[mission_item_int.seq];
+    cmd = {};
+    const MAV_MISSION_RESULT res = AP_Mission::mavlink_int_to_mission_cmd(mission_item_int, cmd);
+    if (res != MAV_MISSION_ACCEPTED) {
+        return res;
+    }
+    cmd.index = mission_item_int.seq;
+
+    // DO_JUMP targets are checked against the whole mission in
+    // commit_staged_items as they may refer to later items
+    return MAV_MISSION_ACCEPTED;
+}
+
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::commit_staged_items(const GCS_MAVLINK &_link)
+{
+    // validate the mission as a whole before touching storage
+    for (uint16_t i=1; i<_new_items_count; i++) {
+        const AP_Mission::Mission_Command &cmd = _new_items[i];
+        if (cmd.id == MAV_CMD_DO_JUMP &&
+            (cmd.content.jump.target >= _new_items_count || cmd.content.jump.target == 0)) {
+            _link.send_text(MAV_SEVERITY_WARNING, "Mission item %u: bad jump target", (unsigned)i);
+            return MAV_MISSION_ERROR;
+        }
+    }
+
+    WITH_SEMAPHORE(mission.get_semaphore());
+
+    // item zero is home and is never written from an upload
+    if (mission.num_commands() < 1) {
+        mission.write_home_to_storage();
+    }
+    if (_new_items_count > 1 &&
+        !mission.write_cmd_range(1, &_new_items[1], _new_items_count-1)) {
+        _link.send_text(MAV_SEVERITY_WARNING, "Mission write failed");
+        return MAV_MISSION_ERROR;
+    }
+    mission.truncate(MAX(_new_items_count, 1U));
+
+    return MAV_MISSION_ACCEPTED;
+}
+#endif  // AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+
 #endif  // HAL_GCS_ENABLED && AP_MISSION_ENABLED
@@ -3,6 +3,8 @@
 #include "MissionItemProtocol.h"
 
 class MissionItemProtocol_Waypoints : public MissionItemProtocol {
+    friend class MissionItemProtocol_Waypoints_Test;
+
 public:
     MissionItemProtocol_Waypoints(class AP_Mission &_mission) :
         mission(_mission) {}
@@ -58,5 +60,21 @@ private:
     // replace_item() replaces an item in the stored list
     MAV_MISSION_RESULT replace_item(const mavlink_mission_item_int_t &) override WARN_IF_UNUSED;
 
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+    // a complete mission upload is received into _new_items and only
+    // written to storage by complete(), so the active mission is
+    // untouched until the new one has been received and validated.
+    // If the allocation fails items are written straight to storage.
+    void free_upload_resources() override;
+    MAV_MISSION_RESULT allocate_receive_resources(const uint16_t count) override WARN_IF_UNUSED;
+
+    // returns true if the current upload is being staged in RAM
+    bool staging() const { return _new_items != nullptr; }
+    MAV_MISSION_RESULT stage_item(const mavlink_mission_item_int_t &mission_item_int) WARN_IF_UNUSED;
+    MAV_MISSION_RESULT commit_staged_items(const GCS_MAVLINK &_link) WARN_IF_UNUSED;
+
+    AP_Mission::Mission_Command *_new_items;
+    uint16_t _new_items_count;
+#endif
 };
 
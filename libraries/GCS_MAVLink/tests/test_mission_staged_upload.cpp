@@ -0,0 +1,237 @@
+#include <AP_gtest.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_Mission/AP_Mission.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+#include <GCS_MAVLink/MissionItemProtocol_Waypoints.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+
+AP_AHRS ahrs{AP_AHRS::FLAG_ALWAYS_USE_EKF};
+GCS_Dummy _gcs;
+
+class MissionItemProtocol_Waypoints_Test
+{
+public:
+    // replace the stored mission with waypoints at the given altitudes
+    void store_mission(const int32_t *alt_cm, uint16_t count)
+    {
+        if (!initialised) {
+            mission.init();
+            initialised = true;
+        }
+        // the first add_cmd() also writes home
+        mission.clear();
+        for (uint16_t i=0; i<count; i++) {
+            AP_Mission::Mission_Command cmd {};
+            cmd.id = MAV_CMD_NAV_WAYPOINT;
+            cmd.content.location = Location{lat(i+1), lng(i+1), alt_cm[i], Location::AltFrame::ABOVE_HOME};
+            ASSERT_TRUE(mission.add_cmd(cmd));
+        }
+    }
+
+    // start an upload of count items, including home, as
+    // handle_mission_count() would
+    void begin_upload(uint16_t count)
+    {
+        ASSERT_EQ(MAV_MISSION_ACCEPTED, protocol.allocate_receive_resources(count));
+        ASSERT_TRUE(protocol.staging());
+        mavlink_mission_count_t packet {};
+        packet.count = count;
+        protocol.truncate(packet);
+        protocol.receiving = true;
+    }
+
+    MAV_MISSION_RESULT send_waypoint(uint16_t seq, int32_t alt_cm)
+    {
+        mavlink_mission_item_int_t item {};
+        item.seq = seq;
+        item.command = MAV_CMD_NAV_WAYPOINT;
+        item.frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+        item.x = lat(seq);
+        item.y = lng(seq);
+        item.z = alt_cm / 100.0f;
+        return send_item(item);
+    }
+
+    MAV_MISSION_RESULT send_jump(uint16_t seq, uint16_t target)
+    {
+        mavlink_mission_item_int_t item {};
+        item.seq = seq;
+        item.command = MAV_CMD_DO_JUMP;
+        item.frame = MAV_FRAME_MISSION;
+        item.param1 = target;
+        item.param2 = 1;
+        return send_item(item);
+    }
+
+    MAV_MISSION_RESULT finish_upload()
+    {
+        const MAV_MISSION_RESULT ret = protocol.commit_staged_items(link);
+        abort_upload();
+        return ret;
+    }
+
+    // tidy up as the base class does on timeout or cancel
+    void abort_upload()
+    {
+        protocol.receiving = false;
+        protocol.free_upload_resources();
+    }
+
+    bool staging() const { return protocol.staging(); }
+
+    // check the stored mission holds waypoints at the given altitudes
+    void expect_mission(const int32_t *alt_cm, uint16_t count)
+    {
+        ASSERT_EQ(count+1, mission.num_commands());
+        for (uint16_t i=0; i<count; i++) {
+            AP_Mission::Mission_Command cmd;
+            // read twice so the second read is served from the
+            // command cache where that is enabled
+            ASSERT_TRUE(mission.read_cmd_from_storage(i+1, cmd));
+            ASSERT_TRUE(mission.read_cmd_from_storage(i+1, cmd));
+            EXPECT_EQ(MAV_CMD_NAV_WAYPOINT, cmd.id);
+            EXPECT_EQ(lat(i+1), cmd.content.location.lat);
+            EXPECT_EQ(lng(i+1), cmd.content.location.lng);
+            EXPECT_EQ(alt_cm[i], cmd.content.location.alt);
+        }
+    }
+
+    AP_Mission mission{
+        FUNCTOR_BIND_MEMBER(&MissionItemProtocol_Waypoints_Test::start_cmd, bool, const AP_Mission::Mission_Command &),
+        FUNCTOR_BIND_MEMBER(&MissionItemProtocol_Waypoints_Test::verify_cmd, bool, const AP_Mission::Mission_Command &),
+        FUNCTOR_BIND_MEMBER(&MissionItemProtocol_Waypoints_Test::mission_complete, void)};
+
+private:
+    static int32_t lat(uint16_t seq) { return -353632610 + seq * 100; }
+    static int32_t lng(uint16_t seq) { return 1491652300 + seq * 100; }
+
+    MAV_MISSION_RESULT send_item(const mavlink_mission_item_int_t &item)
+    {
+        // as handle_mission_item() does
+        if (item.seq < protocol.item_count()) {
+            return protocol.replace_item(item);
+        }
+        return protocol.append_item(item);
+    }
+
+    bool start_cmd(const AP_Mission::Mission_Command &cmd) { return true; }
+    bool verify_cmd(const AP_Mission::Mission_Command &cmd) { return true; }
+    void mission_complete(void) {}
+
+    MissionItemProtocol_Waypoints protocol{mission};
+    GCS_MAVLINK_Dummy link{*hal.serial(0)};
+    bool initialised;
+};
+
+// AP_Mission is a singleton, so all tests share one instance
+static MissionItemProtocol_Waypoints_Test upload_test;
+
+static const int32_t old_alts[] { 1000, 2000, 3000, 4000, 5000 };
+
+TEST(MissionStagedUpload, StoredMissionUntouchedUntilComplete)
+{
+    upload_test.store_mission(old_alts, 3);
+    upload_test.expect_mission(old_alts, 3);
+
+    const int32_t new_alts[] { 1100, 2200, 3300 };
+    upload_test.begin_upload(4);
+    for (uint16_t seq=0; seq<4; seq++) {
+        EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(seq, seq == 0 ? 0 : new_alts[seq-1]));
+        // the active mission, and what is cached of it, stays as it was
+        upload_test.expect_mission(old_alts, 3);
+    }
+
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.finish_upload());
+    // no command cached from the old mission may be returned
+    upload_test.expect_mission(new_alts, 3);
+}
+
+TEST(MissionStagedUpload, ShorterMissionThenRegrow)
+{
+    upload_test.store_mission(old_alts, 5);
+    upload_test.expect_mission(old_alts, 5);
+
+    const int32_t short_alts[] { 1200, 2400 };
+    upload_test.begin_upload(3);
+    for (uint16_t seq=0; seq<3; seq++) {
+        EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(seq, seq == 0 ? 0 : short_alts[seq-1]));
+    }
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.finish_upload());
+    upload_test.expect_mission(short_alts, 2);
+
+    AP_Mission::Mission_Command cmd;
+    EXPECT_FALSE(upload_test.mission.read_cmd_from_storage(3, cmd));
+
+    // items 3 and 4 were cached before the short upload, growing the
+    // mission again must return the new ones
+    const int32_t long_alts[] { 1300, 2600, 3900, 5200 };
+    upload_test.begin_upload(5);
+    for (uint16_t seq=0; seq<5; seq++) {
+        EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(seq, seq == 0 ? 0 : long_alts[seq-1]));
+    }
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.finish_upload());
+    upload_test.expect_mission(long_alts, 4);
+}
+
+TEST(MissionStagedUpload, ResentItemReplacesStaged)
+{
+    upload_test.store_mission(old_alts, 2);
+
+    const int32_t new_alts[] { 1400, 2800 };
+    upload_test.begin_upload(3);
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(0, 0));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(1, 9900));
+    // the GCS resends item 1 with a different value
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(1, new_alts[0]));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(2, new_alts[1]));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.finish_upload());
+    upload_test.expect_mission(new_alts, 2);
+}
+
+TEST(MissionStagedUpload, BadJumpLeavesMission)
+{
+    upload_test.store_mission(old_alts, 3);
+    upload_test.expect_mission(old_alts, 3);
+
+    upload_test.begin_upload(4);
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(0, 0));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(1, 1500));
+    // the target is checked against the whole mission at the end
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_jump(2, 7));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(3, 3500));
+    EXPECT_EQ(MAV_MISSION_ERROR, upload_test.finish_upload());
+
+    upload_test.expect_mission(old_alts, 3);
+}
+
+TEST(MissionStagedUpload, AbortedUploadLeavesMission)
+{
+    upload_test.store_mission(old_alts, 4);
+
+    upload_test.begin_upload(5);
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(0, 0));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(1, 1600));
+    EXPECT_EQ(MAV_MISSION_ACCEPTED, upload_test.send_waypoint(2, 3200));
+    upload_test.abort_upload();
+    EXPECT_FALSE(upload_test.staging());
+
+    upload_test.expect_mission(old_alts, 4);
+}
+
+TEST(MissionStagedUpload, SequenceOutOfRange)
+{
+    upload_test.store_mission(old_alts, 1);
+
+    upload_test.begin_upload(2);
+    EXPECT_EQ(MAV_MISSION_INVALID_SEQUENCE, upload_test.send_waypoint(2, 1700));
+    upload_test.abort_upload();
+
+    upload_test.expect_mission(old_alts, 1);
+}
+
+#endif // AP_MAVLINK_MISSION_STAGED_UPLOAD_ENABLED
+
+AP_GTEST_MAIN()
@@ -288,14 +288,19 @@ void Aircraft::sync_frame_time(void)
     uint64_t now = get_wall_time_us();
     uint64_t dt_us = now - last_wall_time_us;
 
-    const float target_dt_us = 1.0e6/(rate_hz*target_speedup);
+    if (is_positive(target_speedup)) {
+        const float target_dt_us = 1.0e6/(rate_hz*target_speedup);
 
-    // accumulate sleep debt if we're running too fast
-    sleep_debt_us += target_dt_us - dt_us;
+        // accumulate sleep debt if we're running too fast
+        sleep_debt_us += target_dt_us - dt_us;
 
-    if (sleep_debt_us < -1.0e5) {
-        // don't let a large negative debt build up
-        sleep_debt_us = -1.0e5;
+        if (sleep_debt_us < -1.0e5) {
+            // don't let a large negative debt build up
+            sleep_debt_us = -1.0e5;
+        }
+    } else {
+        // run as fast as possible, never sleeping
+        sleep_debt_us = 0;
     }
     if (sleep_debt_us > min_sleep_time) {
         // sleep if we have built up a debt of min_sleep_tim
@@ -306,7 +311,9 @@ void Aircraft::sync_frame_time(void)
 #else
         // ??
 #endif
-        sleep_debt_us -= (get_wall_time_us() - now);
+        const uint64_t slept_us = get_wall_time_us() - now;
+        sleep_debt_us -= slept_us;
+        sleep_total_us += slept_us;
     }
     last_wall_time_us = get_wall_time_us();
 
@@ -472,8 +479,10 @@ void Aircraft::fill_fdm(struct sitl_fdm &fdm)
         sitl->speedup.set(get_speedup());
     }
     
-    if (!is_equal(last_speedup, float(sitl->speedup)) && sitl->speedup > 0) {
+    if (!is_equal(last_speedup, float(sitl->speedup)) && sitl->speedup >= 0) {
         set_speedup(sitl->speedup);
+        // the model may not support the requested speedup
+        sitl->speedup.set(get_speedup());
         last_speedup = sitl->speedup;
     }
 
@@ -674,6 +683,12 @@ uint64_t Aircraft::get_wall_time_us() const
  */
 void Aircraft::set_speedup(float speedup)
 {
+    if (!is_positive(speedup) && !use_time_sync) {
+        // models paced by an external realtime simulator scale their
+        // rates by the speedup, so cannot run unbounded
+        ::printf("SIM_SPEEDUP=0 not supported by this model, using 1\n");
+        speedup = 1;
+    }
     setup_frame_time(rate_hz, speedup);
 }
 
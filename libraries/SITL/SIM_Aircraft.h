@@ -59,11 +59,14 @@ public:
     virtual void set_start_location(const Location &start_loc, const float start_yaw);
 
     /*
-      set simulation speedup
+      set simulation speedup, zero runs as fast as possible
      */
     void set_speedup(float speedup);
     float get_speedup() const { return target_speedup; }
 
+    // total wall clock time spent sleeping to match the speedup
+    uint64_t get_sleep_time_us() const { return sleep_total_us; }
+
     /*
       set instance number
      */
@@ -265,12 +268,13 @@ protected:
     const float gyro_noise = radians(0.1f);
     const float accel_noise = 0.3f;
     float rate_hz = 1200.0f;
-    float target_speedup;
+    float target_speedup = 1.0f;
     uint64_t frame_time_us;
     uint64_t last_wall_time_us;
     uint32_t last_fps_report_ms;
     float achieved_rate_hz;  // achieved speedup rate
     int64_t sleep_debt_us;
+    uint64_t sleep_total_us;
     uint32_t last_frame_count;
     uint8_t instance;
     const char *autotest_dir;
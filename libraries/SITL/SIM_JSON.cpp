@@ -25,12 +25,22 @@
 #include <stdio.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#if AP_SIM_JSON_SHM_ENABLED
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <unistd.h>
+#endif
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Logger/AP_Logger.h>
 #include <AP_HAL/utility/replace.h>
 #include <SRV_Channel/SRV_Channel.h>
 #include <AP_Filesystem/AP_Filesystem.h>
+#include <GCS_MAVLink/GCS.h>
 
 #define UDP_TIMEOUT_MS 100
 
@@ -71,6 +81,14 @@ JSON::JSON(const char *frame_str) :
         target_ip = colon+1;
     }
 
+#if AP_SIM_JSON_SHM_ENABLED
+    if (strncmp(target_ip, "shm:", 4) == 0) {
+        if (!shm_open_region(target_ip+4)) {
+            AP_HAL::panic("JSON: failed to open shared memory %s", target_ip+4);
+        }
+    }
+#endif
+
     for (uint8_t i=0; i<ARRAY_SIZE(sim_defaults); i++) {
     AP_Param::set_default_by_name(sim_defaults[i].name, sim_defaults[i].value);
         if (sim_defaults[i].save) {
@@ -104,6 +122,23 @@ void JSON::set_interface_ports(const char* address, const int port_in, const int
 */
 void JSON::output_servos(const struct sitl_input &input)
 {
+#if AP_SIM_JSON_SHM_ENABLED
+    if (shm != nullptr) {
+        servo_packet_32 pkt {};
+        if (!SRV_Channels::have_32_channels()) {
+            pkt.magic = servo_packet_16().magic;
+        }
+        pkt.frame_rate = rate_hz;
+        pkt.frame_count = frame_counter;
+        const uint8_t num_chan = SRV_Channels::have_32_channels() ? 32 : 16;
+        for (uint8_t i=0; i<num_chan; i++) {
+            pkt.pwm[i] = input.servos[i];
+        }
+        shm_output_servos(pkt);
+        return;
+    }
+#endif
+
     size_t pkt_size = 0;
     ssize_t send_ret = -1;
     if (SRV_Channels::have_32_channels()) {
@@ -297,25 +332,249 @@ uint64_t JSON::parse_sensors(const char *json)
 }
 
 /*
-    Receive new sensor data from simulator
-    This is a blocking function
+    decode a binary sensor frame into the state structure, returning
+    the bitmask of received fields, or zero if the frame is invalid or
+    a mandatory field is missing
 */
-void JSON::recv_fdm(const struct sitl_input &input)
+uint64_t JSON::decode_binary(const fdm_packet_bin &pkt)
+{
+    if (pkt.magic != BIN_MAGIC ||
+        pkt.version != BIN_VERSION ||
+        pkt.length != sizeof(pkt)) {
+        const uint32_t now_ms = AP_HAL::millis();
+        if (now_ms - last_bad_frame_ms >= 5000) {
+            last_bad_frame_ms = now_ms;
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "JSON: bad binary frame version=%u length=%u",
+                          unsigned(pkt.version), unsigned(pkt.length));
+        }
+        return 0;
+    }
+
+    const uint64_t received_bitmask = pkt.fields & ((1ULL << ARRAY_SIZE(keytable)) - 1);
+    for (uint16_t i=0; i<ARRAY_SIZE(keytable); i++) {
+        if (keytable[i].required && (received_bitmask & (1ULL << i)) == 0) {
+            printf("Failed to find %s\n", keytable[i].key);
+            return 0;
+        }
+    }
+
+    // as with the text format, fields not present keep their last value
+    if (received_bitmask & TIMESTAMP) {
+        state.timestamp_s = pkt.timestamp_s;
+    }
+    if (received_bitmask & LATITUDE) {
+        state.latitude = pkt.latitude;
+    }
+    if (received_bitmask & LONGITUDE) {
+        state.longitude = pkt.longitude;
+    }
+    if (received_bitmask & ALTITUDE) {
+        state.altitude = pkt.altitude;
+    }
+    if (received_bitmask & GYRO) {
+        state.imu.gyro = Vector3f(pkt.gyro[0], pkt.gyro[1], pkt.gyro[2]);
+    }
+    if (received_bitmask & ACCEL_BODY) {
+        state.imu.accel_body = Vector3f(pkt.accel_body[0], pkt.accel_body[1], pkt.accel_body[2]);
+    }
+    if (received_bitmask & POSITION) {
+        state.position = Vector3d(pkt.position[0], pkt.position[1], pkt.position[2]);
+    }
+    if (received_bitmask & EULER_ATT) {
+        state.attitude = Vector3f(pkt.attitude[0], pkt.attitude[1], pkt.attitude[2]);
+    }
+    if (received_bitmask & QUAT_ATT) {
+        state.quaternion = Quaternion(pkt.quaternion[0], pkt.quaternion[1], pkt.quaternion[2], pkt.quaternion[3]);
+    }
+    if (received_bitmask & VELOCITY) {
+        state.velocity = Vector3f(pkt.velocity[0], pkt.velocity[1], pkt.velocity[2]);
+    }
+    for (uint8_t i=0; i<ARRAY_SIZE(state.rng); i++) {
+        if (received_bitmask & (RNG_1 << i)) {
+            state.rng[i] = pkt.rng[i];
+        }
+    }
+    if (received_bitmask & WIND_VEL) {
+        state.velocity_wind = Vector3f(pkt.velocity_wind[0], pkt.velocity_wind[1], pkt.velocity_wind[2]);
+    }
+    if (received_bitmask & WIND_DIR) {
+        state.wind_vane_apparent.direction = pkt.windvane_direction;
+    }
+    if (received_bitmask & WIND_SPD) {
+        state.wind_vane_apparent.speed = pkt.windvane_speed;
+    }
+    if (received_bitmask & AIRSPEED) {
+        state.airspeed = pkt.airspeed;
+    }
+    if (received_bitmask & TIME_SYNC) {
+        state.no_time_sync = pkt.no_time_sync != 0;
+    }
+    if (received_bitmask & LOCKSTEP) {
+        state.no_lockstep = pkt.no_lockstep != 0;
+    }
+    static_assert(ARRAY_SIZE(state.rc) == ARRAY_SIZE(pkt.rc), "JSON binary rc size mismatch");
+    for (uint8_t i=0; i<ARRAY_SIZE(state.rc); i++) {
+        if (received_bitmask & (RC_1 << i)) {
+            state.rc[i] = pkt.rc[i];
+        }
+    }
+    if (received_bitmask & BAT_VOLT) {
+        state.bat_volt = pkt.bat_volt;
+    }
+    if (received_bitmask & BAT_AMP) {
+        state.bat_amp = pkt.bat_amp;
+    }
+
+    return received_bitmask;
+}
+
+/*
+    in no_lockstep mode do not block waiting for data; advance time using SITL loop rate
+*/
+void JSON::advance_time_no_lockstep()
+{
+    if (sitl != nullptr && sitl->loop_rate_hz > 0) {
+        frame_time_us = (uint32_t)(1000000.0f / sitl->loop_rate_hz);
+    } else {
+        frame_time_us = 10000; // fallback to 10ms
+    }
+    time_now_us += frame_time_us;
+    time_advance();
+}
+
+#if AP_SIM_JSON_SHM_ENABLED
+/*
+    create (or reset) the shared memory region used to talk to a simulator on the same host
+*/
+bool JSON::shm_open_region(const char *name)
+{
+    char path[64];
+    if (hal.util->snprintf(path, sizeof(path), "/%s", name) >= int(sizeof(path))) {
+        return false;
+    }
+    const int fd = shm_open(path, O_RDWR | O_CREAT, 0600);
+    if (fd == -1) {
+        printf("JSON: shm_open(%s) failed: %s\n", path, strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(shm_region)) != 0) {
+        printf("JSON: ftruncate(%s) failed: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(shm_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        printf("JSON: mmap(%s) failed: %s\n", path, strerror(errno));
+        return false;
+    }
+    shm = (shm_region *)p;
+    strncpy(shm_name, path, sizeof(shm_name)-1);
+    // SITL exits without deleting the model, so also remove the
+    // region at exit
+    shm_owner = this;
+    atexit(shm_atexit);
+    memset(shm, 0, sizeof(*shm));
+    shm->version = SHM_VERSION;
+    shm->header_size = offsetof(shm_region, servo_seq);
+    __atomic_store_n(&shm->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+    printf("JSON shared memory interface %s (%u bytes)\n", path, unsigned(sizeof(shm_region)));
+    return true;
+}
+
+/*
+    unmap and remove the shared memory region. A simulator which still
+    has it mapped keeps its mapping, but a new JSON instance will
+    create a fresh region
+*/
+void JSON::shm_close_region(void)
+{
+    if (shm == nullptr) {
+        return;
+    }
+    munmap(shm, sizeof(shm_region));
+    shm = nullptr;
+    shm_unlink(shm_name);
+    if (shm_owner == this) {
+        shm_owner = nullptr;
+    }
+}
+
+JSON *JSON::shm_owner;
+
+void JSON::shm_atexit(void)
+{
+    if (shm_owner != nullptr) {
+        shm_owner->shm_close_region();
+    }
+}
+
+/*
+    publish servo outputs to the shared memory region and wake the simulator
+*/
+void JSON::shm_output_servos(const servo_packet_32 &pkt)
+{
+    const uint32_t seq = __atomic_load_n(&shm->servo_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->servo_seq, seq+1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&shm->servo, &pkt, sizeof(pkt));
+    __atomic_store_n(&shm->servo_seq, seq+2, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shm->servo_seq, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+/*
+    wait for a new sensor frame in the shared memory region
+    returns false if time was advanced without a new frame
+*/
+bool JSON::recv_fdm_shm(const struct sitl_input &input, uint64_t &received_bitmask)
+{
+    uint32_t wait_ms = 0;
+    while (true) {
+        const uint32_t seq = __atomic_load_n(&shm->fdm_seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1U) == 0 && seq != shm_fdm_seq) {
+            fdm_packet_bin pkt;
+            memcpy(&pkt, &shm->fdm, sizeof(pkt));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&shm->fdm_seq, __ATOMIC_RELAXED) != seq) {
+                // writer updated the frame while we were copying it
+                continue;
+            }
+            shm_fdm_seq = seq;
+            received_bitmask = decode_binary(pkt);
+            return true;
+        }
+        if (state.no_lockstep) {
+            advance_time_no_lockstep();
+            return false;
+        }
+        const struct timespec ts { 0, UDP_TIMEOUT_MS * 1000000L };
+        syscall(SYS_futex, &shm->fdm_seq, FUTEX_WAIT, seq, &ts, nullptr, 0);
+        if (seq == __atomic_load_n(&shm->fdm_seq, __ATOMIC_RELAXED)) {
+            wait_ms += UDP_TIMEOUT_MS;
+        }
+        if (wait_ms > 1000) {
+            wait_ms = 0;
+            printf("No JSON sensor frame received, resending servos\n");
+            output_servos(input);
+        }
+    }
+}
+#endif  // AP_SIM_JSON_SHM_ENABLED
+
+/*
+    Receive new sensor data from the simulator over UDP, either as
+    newline separated JSON text or as a binary frame
+    This is a blocking function, returns false if no frame was decoded
+*/
+bool JSON::recv_fdm_socket(const struct sitl_input &input, uint64_t &received_bitmask)
 {
     // Receive sensor packet
     ssize_t ret = sock.recv(&sensor_buffer[sensor_buffer_len], sizeof(sensor_buffer)-sensor_buffer_len, UDP_TIMEOUT_MS);
     uint32_t wait_ms = UDP_TIMEOUT_MS;
 
     if (state.no_lockstep && ret <= 0) {
-        // in no_lockstep mode do not block waiting for data; advance time using SITL loop rate
-        if (sitl != nullptr && sitl->loop_rate_hz > 0) {
-            frame_time_us = (uint32_t)(1000000.0f / sitl->loop_rate_hz);
-        } else {
-            frame_time_us = 10000; // fallback to 10ms
-        }
-        time_now_us += frame_time_us;
-        time_advance();
-        return;
+        advance_time_no_lockstep();
+        return false;
     }
 
     while (ret <= 0) {
@@ -330,6 +589,16 @@ void JSON::recv_fdm(const struct sitl_input &input)
         }
     }
 
+    // binary frames are a whole datagram and skip the text parser
+    const uint8_t *frame = &sensor_buffer[sensor_buffer_len];
+    if (size_t(ret) == sizeof(fdm_packet_bin) &&
+        frame[0] == (BIN_MAGIC & 0xFF) && frame[1] == (BIN_MAGIC >> 8)) {
+        fdm_packet_bin pkt;
+        memcpy(&pkt, frame, sizeof(pkt));
+        received_bitmask = decode_binary(pkt);
+        return true;
+    }
+
     // convert '\n' into nul
     while (uint8_t *p = (uint8_t *)memchr(&sensor_buffer[sensor_buffer_len], '\n', ret)) {
         *p = 0;
@@ -338,15 +607,40 @@ void JSON::recv_fdm(const struct sitl_input &input)
 
     const uint8_t *p2 = (const uint8_t *)memrchr(sensor_buffer, 0, sensor_buffer_len);
     if (p2 == nullptr || p2 == sensor_buffer) {
-        return;
+        return false;
     }
 
     const uint8_t *p1 = (const uint8_t *)memrchr(sensor_buffer, 0, p2 - sensor_buffer);
     if (p1 == nullptr) {
+        return false;
+    }
+
+    received_bitmask = parse_sensors((const char *)(p1+1));
+
+    memmove(sensor_buffer, p2, sensor_buffer_len - (p2 - sensor_buffer));
+    sensor_buffer_len = sensor_buffer_len - (p2 - sensor_buffer);
+
+    return true;
+}
+
+/*
+    Receive new sensor data from simulator
+    This is a blocking function
+*/
+void JSON::recv_fdm(const struct sitl_input &input)
+{
+    uint64_t received_bitmask = 0;
+#if AP_SIM_JSON_SHM_ENABLED
+    if (shm != nullptr) {
+        if (!recv_fdm_shm(input, received_bitmask)) {
+            return;
+        }
+    } else
+#endif
+    if (!recv_fdm_socket(input, received_bitmask)) {
         return;
     }
 
-    const uint64_t received_bitmask = parse_sensors((const char *)(p1+1));
     if (received_bitmask == 0) {
         // did not receive one of the mandatory fields
         printf("Did not contain all mandatory fields\n");
@@ -377,9 +671,6 @@ void JSON::recv_fdm(const struct sitl_input &input)
     }
     last_received_bitmask = received_bitmask;
 
-    memmove(sensor_buffer, p2, sensor_buffer_len - (p2 - sensor_buffer));
-    sensor_buffer_len = sensor_buffer_len - (p2 - sensor_buffer);
-
     accel_body = state.imu.accel_body;
     gyro = state.imu.gyro;
     velocity_ef = state.velocity;
@@ -28,6 +28,9 @@ namespace SITL {
 class JSON : public Aircraft {
 public:
     JSON(const char *frame_str);
+#if AP_SIM_JSON_SHM_ENABLED
+    ~JSON() { shm_close_region(); }
+#endif
 
     /* update model by one time step */
     void update(const struct sitl_input &input) override;
@@ -56,6 +59,40 @@ private:
         uint16_t pwm[32];
     };
 
+    /*
+      binary sensor frame, an alternative to the JSON text frame. Fields
+      are in keytable order and "fields" is a DataKey bitmask of the
+      fields that are valid
+     */
+    static const uint16_t BIN_MAGIC = 0x4A53;
+    static const uint16_t BIN_VERSION = 1;
+    struct PACKED fdm_packet_bin {
+        uint16_t magic;
+        uint16_t version;
+        uint32_t length;        // sizeof(fdm_packet_bin)
+        uint64_t fields;
+        double timestamp_s;
+        double latitude;
+        double longitude;
+        double altitude;
+        float gyro[3];
+        float accel_body[3];
+        double position[3];
+        float attitude[3];
+        float quaternion[4];
+        float velocity[3];
+        float rng[6];
+        float velocity_wind[3];
+        float windvane_direction;
+        float windvane_speed;
+        float airspeed;
+        uint8_t no_time_sync;
+        uint8_t no_lockstep;
+        float rc[12];
+        float bat_volt;
+        float bat_amp;
+    };
+
     // default connection_info_.ip_address
     const char *target_ip = "127.0.0.1";
 
@@ -74,8 +111,41 @@ private:
 
     void output_servos(const struct sitl_input &input);
     void recv_fdm(const struct sitl_input &input);
+    bool recv_fdm_socket(const struct sitl_input &input, uint64_t &received_bitmask);
+    void advance_time_no_lockstep();
 
     uint64_t parse_sensors(const char *json);
+    uint64_t decode_binary(const fdm_packet_bin &pkt);
+
+#if AP_SIM_JSON_SHM_ENABLED
+    /*
+      shared memory transport for simulators on the same host, selected
+      with --model JSON:shm:NAME. Each direction is a single slot guarded
+      by a sequence counter (odd while being written) which is also used
+      as a futex word to wake the reader
+     */
+    static const uint32_t SHM_MAGIC = 0x4A534D31;
+    static const uint16_t SHM_VERSION = 1;
+    struct shm_region {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t header_size;   // offsetof(shm_region, servo_seq)
+        uint32_t servo_seq;
+        servo_packet_32 servo;
+        uint32_t fdm_seq;
+        fdm_packet_bin fdm;
+    };
+    shm_region *shm;
+    char shm_name[64];
+    uint32_t shm_fdm_seq;
+
+    bool shm_open_region(const char *name);
+    void shm_close_region(void);
+    static JSON *shm_owner;
+    static void shm_atexit(void);
+    void shm_output_servos(const servo_packet_32 &pkt);
+    bool recv_fdm_shm(const struct sitl_input &input, uint64_t &received_bitmask);
+#endif
 
     // buffer for parsing pose data in JSON format
     uint8_t sensor_buffer[65000];
@@ -204,6 +274,7 @@ private:
         BAT_AMP     = 0x0000000800000000ULL, // 1ULL << 35
     };
     uint64_t last_received_bitmask;
+    uint32_t last_bad_frame_ms;
 
 #if SITL_JSON_DEBUG
     uint32_t last_debug_ms;
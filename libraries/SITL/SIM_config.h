@@ -321,6 +321,14 @@
 #define AP_SIM_JSON_MASTER_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
 #endif  // AP_SIM_JSON_MASTER_ENABLED
 
+#ifndef AP_SIM_JSON_SHM_ENABLED
+#if defined(__linux__)
+#define AP_SIM_JSON_SHM_ENABLED AP_SIM_JSON_ENABLED
+#else
+#define AP_SIM_JSON_SHM_ENABLED 0
+#endif
+#endif  // AP_SIM_JSON_SHM_ENABLED
+
 #ifndef AP_SIM_LAST_LETTER_ENABLED
 #define AP_SIM_LAST_LETTER_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
 #endif  // AP_SIM_LAST_LETTER_ENABLED
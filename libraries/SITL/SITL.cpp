@@ -225,8 +225,8 @@ const AP_Param::GroupInfo SIM::var_info[] = {
     AP_GROUPINFO("ADSB_TX",       51, SIM,  adsb_tx, 0),
     // @Param: SPEEDUP
     // @DisplayName: Sim Speedup
-    // @Description: Runs the simulation at multiples of normal speed. Do not use if realtime physics, like RealFlight, is being used
-    // @Range: 1 10
+    // @Description: Runs the simulation at multiples of normal speed. A value of 0 runs the simulation as fast as the CPU allows without ever sleeping, it is not supported by models paced by an external simulator and is replaced by 1 for them. Do not use if realtime physics, like RealFlight, is being used
+    // @Range: 0 10
     // @User: Advanced
     AP_GROUPINFO("SPEEDUP",       52, SIM,  speedup, 1),
     // @Param: IMU_POS
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+'''
+Reference physics backend for the binary and shared memory input
+formats of the SITL JSON model, see ../readme.md.
+
+The vehicle is a point mass which can only move vertically. The mean
+of the first four servo outputs sets the thrust, so a copter will
+climb and descend when flown in a vertical mode. It is only meant to
+show how to exchange frames with SITL.
+
+UDP, with SITL started with --model JSON:
+    ./binary_client.py
+
+Shared memory on Linux, with SITL started with --model JSON:shm:apjson
+    ./binary_client.py --shm apjson
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import ctypes
+import mmap
+import os
+import socket
+import struct
+import time
+
+GRAVITY = 9.80665
+
+SERVO_MAGIC_16 = 18458
+SERVO_MAGIC_32 = 29569
+SERVO_HEADER = struct.Struct('<HHI')
+
+BIN_MAGIC = 0x4A53
+BIN_VERSION = 1
+FDM_FRAME = struct.Struct('<HHIQ' + 'd' + 'ddd' + '3f' + '3f' + '3d' + '3f' + '4f' + '3f' + '6f' + '3f' + 'ff' + 'f' + 'BB' + '12f' + 'ff')
+
+# bits in the fields mask, in the order of the JSON backend keytable
+TIMESTAMP = 1 << 0
+GYRO = 1 << 4
+ACCEL_BODY = 1 << 5
+POSITION = 1 << 6
+QUAT_ATT = 1 << 8
+VELOCITY = 1 << 9
+
+SHM_MAGIC = 0x4A534D31
+SHM_SERVO_SEQ = 8
+SHM_SERVO = 12
+SHM_FDM_SEQ = SHM_SERVO + SERVO_HEADER.size + 32*2
+SHM_FDM = SHM_FDM_SEQ + 4
+
+FUTEX_WAIT = 0
+FUTEX_WAKE = 1
+SYS_FUTEX = {'x86_64': 202, 'aarch64': 98}.get(os.uname().machine)
+
+
+class Vehicle(object):
+    '''vertical only point mass'''
+
+    def __init__(self):
+        self.time_s = 0.0
+        self.down = 0.0
+        self.vel_down = 0.0
+        self.accel_down = 0.0
+
+    def update(self, frame_rate, pwm):
+        dt = 1.0 / max(frame_rate, 1)
+        throttle = (sum(pwm[0:4]) / 4.0 - 1000) / 1000.0
+        throttle = min(max(throttle, 0.0), 1.0)
+        self.accel_down = GRAVITY - throttle * 2 * GRAVITY
+        self.vel_down += self.accel_down * dt
+        self.down += self.vel_down * dt
+        if self.down >= 0:
+            # on the ground
+            self.down = 0.0
+            self.vel_down = min(self.vel_down, 0.0)
+            self.accel_down = 0.0
+        self.time_s += dt
+
+    def frame(self):
+        fields = TIMESTAMP | GYRO | ACCEL_BODY | POSITION | QUAT_ATT | VELOCITY
+        # the accelerometer measures specific force, so reads -g at rest
+        accel_z = self.accel_down - GRAVITY
+        return FDM_FRAME.pack(
+            BIN_MAGIC, BIN_VERSION, FDM_FRAME.size, fields,
+            self.time_s,
+            0, 0, 0,
+            0, 0, 0,
+            0, 0, accel_z,
+            0, 0, self.down,
+            0, 0, 0,
+            1, 0, 0, 0,
+            0, 0, self.vel_down,
+            *([0] * 6),
+            0, 0, 0,
+            0, 0,
+            0,
+            0, 0,
+            *([0] * 12),
+            0, 0)
+
+
+def decode_servos(data):
+    '''returns (frame_rate, frame_count, pwm) or None'''
+    (magic, frame_rate, frame_count) = SERVO_HEADER.unpack_from(data, 0)
+    if magic == SERVO_MAGIC_16:
+        nchan = 16
+    elif magic == SERVO_MAGIC_32:
+        nchan = 32
+    else:
+        return None
+    pwm = struct.unpack_from('<%uH' % nchan, data, SERVO_HEADER.size)
+    return (frame_rate, frame_count, pwm)
+
+
+def run_udp(vehicle, port):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('', port))
+    sock.settimeout(1.0)
+    last_frame_count = None
+    while True:
+        try:
+            data, address = sock.recvfrom(200)
+        except socket.timeout:
+            continue
+        servos = decode_servos(data)
+        if servos is None:
+            continue
+        (frame_rate, frame_count, pwm) = servos
+        if frame_count == last_frame_count:
+            # a resend, reply without stepping the physics
+            sock.sendto(vehicle.frame(), address)
+            continue
+        last_frame_count = frame_count
+        vehicle.update(frame_rate, pwm)
+        sock.sendto(vehicle.frame(), address)
+
+
+class Futex(object):
+    '''futex wait and wake on a 32 bit word in a shared mapping'''
+
+    def __init__(self, mm):
+        self.libc = ctypes.CDLL(None, use_errno=True)
+        self.mm = mm
+
+    def address(self, offset):
+        return ctypes.addressof(ctypes.c_uint32.from_buffer(self.mm, offset))
+
+    def wait(self, offset, value, timeout_s):
+        if SYS_FUTEX is None:
+            time.sleep(0.0001)
+            return
+        ts = (ctypes.c_long * 2)(0, int(timeout_s * 1e9))
+        self.libc.syscall(SYS_FUTEX, ctypes.c_void_p(self.address(offset)), FUTEX_WAIT,
+                          ctypes.c_uint32(value), ts, None, 0)
+
+    def wake(self, offset):
+        if SYS_FUTEX is not None:
+            self.libc.syscall(SYS_FUTEX, ctypes.c_void_p(self.address(offset)), FUTEX_WAKE,
+                              0x7FFFFFFF, None, None, 0)
+
+
+def run_shm(vehicle, name):
+    fd = os.open('/dev/shm/' + name, os.O_RDWR)
+    mm = mmap.mmap(fd, 0)
+    os.close(fd)
+    (magic,) = struct.unpack_from('<I', mm, 0)
+    if magic != SHM_MAGIC:
+        raise ValueError("bad shared memory magic 0x%08x" % magic)
+    futex = Futex(mm)
+    last_seq = 0
+    while True:
+        (seq,) = struct.unpack_from('<I', mm, SHM_SERVO_SEQ)
+        if seq & 1 or seq == last_seq:
+            futex.wait(SHM_SERVO_SEQ, seq, 0.1)
+            continue
+        data = mm[SHM_SERVO:SHM_FDM_SEQ]
+        if struct.unpack_from('<I', mm, SHM_SERVO_SEQ)[0] != seq:
+            # SITL wrote a new frame while we were copying
+            continue
+        last_seq = seq
+        servos = decode_servos(data)
+        if servos is None:
+            continue
+        (frame_rate, frame_count, pwm) = servos
+        vehicle.update(frame_rate, pwm)
+
+        # publish the sensor frame: odd sequence while writing
+        (fdm_seq,) = struct.unpack_from('<I', mm, SHM_FDM_SEQ)
+        struct.pack_into('<I', mm, SHM_FDM_SEQ, fdm_seq + 1)
+        mm[SHM_FDM:SHM_FDM+FDM_FRAME.size] = vehicle.frame()
+        struct.pack_into('<I', mm, SHM_FDM_SEQ, fdm_seq + 2)
+        futex.wake(SHM_FDM_SEQ)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--port', type=int, default=9002, help='UDP port to listen on')
+    parser.add_argument('--shm', default=None, help='shared memory name given to --model JSON:shm:NAME')
+    args = parser.parse_args()
+
+    vehicle = Vehicle()
+    if args.shm is not None:
+        run_shm(vehicle, args.shm)
+    else:
+        run_udp(vehicle, args.port)
+
+
+if __name__ == '__main__':
+    main()